@@ -0,0 +1,63 @@
+#!/usr/bin/env node
+
+'use strict';
+
+// Compares two runs of a benchmark, e.g. the standard against the LTO and PGO build.
+//
+// Reads the tab-separated outputs of both runs and reports the speedup of
+// every rate column (solutions/s) per row, plus their geometric mean.
+//
+// Usage: node bench/compare.js baseline.tsv optimized.tsv
+
+var fs = require('fs');
+
+
+function readTable(path) {
+  var lines = fs.readFileSync(path, 'utf8').split('\n').filter(function(line) { return line.length > 0; });
+
+  return {
+    header: lines[0].split('\t'),
+    rows: lines.slice(1).map(function(line) { return line.split('\t'); })
+  };
+}
+
+var baseline = readTable(process.argv[2]);
+var optimized = readTable(process.argv[3]);
+
+// Rows are keyed by their first two columns, e.g. size and variant
+var rates = [];
+
+baseline.header.forEach(function(name, column) {
+  if (/\/s$/.test(name))
+    rates.push(column);
+});
+
+var speedups = [];
+
+console.log(baseline.header.slice(0, 2).concat(['rate', 'baseline', 'optimized', 'speedup']).join('\t'));
+
+baseline.rows.forEach(function(row, at) {
+  var other = optimized.rows[at];
+
+  if (!other || other[0] !== row[0] || other[1] !== row[1])
+    throw new Error('Benchmark runs do not match in row ' + (at + 1));
+
+  rates.forEach(function(column) {
+    var before = Number(row[column]);
+    var after = Number(other[column]);
+
+    // Failed solves report their error instead of rates
+    if (!(before > 0) || !(after > 0))
+      return;
+
+    speedups.push(after / before);
+
+    var columns = row.slice(0, 2).concat([baseline.header[column], row[column], other[column]]);
+    console.log(columns.concat([(after / before).toFixed(2) + 'x']).join('\t'));
+  });
+});
+
+if (speedups.length > 0) {
+  var logSum = speedups.reduce(function(sum, speedup) { return sum + Math.log(speedup); }, 0);
+  console.log('geometric mean speedup\t' + Math.exp(logSum / speedups.length).toFixed(2) + 'x');
+}
@@ -0,0 +1,89 @@
+#!/usr/bin/env node
+
+'use strict';
+
+// Compressed against raw matrices on generated instances.
+//
+// Generates the same seeded instance twice per size, once with compressMatrices,
+// and reports the external memory the instance holds and how many solutions per
+// second the search found on it.
+//
+// Usage: node bench/compressed.js [numNodes ..]
+
+var ortools = require('../');
+
+
+// Shorter runs e.g. for collecting profiles, see scripts/build-pgo.sh
+var computeTimeLimit = Number(process.env.BENCH_TIME_LIMIT) || 5000;
+var customersPerVehicle = 10;
+var seed = 42;
+
+var variants = ['raw', 'compressed'];
+
+var sizes = process.argv.slice(2).map(Number);
+
+if (sizes.length === 0)
+  sizes = [100, 200, 400, 800];
+
+
+// Instances report their native matrices as external memory, see VRP::New
+function generate(numNodes, variant) {
+  var before = process.memoryUsage().external;
+
+  var generated = ortools.VRP.generate({
+    numNodes: numNodes,
+    numVehicles: Math.max(1, Math.ceil((numNodes - 1) / customersPerVehicle)),
+    layout: 'random',
+    windowTightness: 0.5,
+    capacityTightness: 0.8,
+    seed: seed + numNodes,
+    compressMatrices: variant === 'compressed'
+  });
+
+  generated.bytes = process.memoryUsage().external - before;
+
+  return generated;
+}
+
+function report(numNodes, variant, generated, err, solution) {
+  var columns = [String(numNodes), variant, (generated.bytes / 1024).toFixed(0)];
+
+  if (err) {
+    columns.push(err.message);
+  } else {
+    var seconds = Math.max(solution.stats.wallTime, 1) / 1000;
+
+    columns.push(String(solution.cost));
+    columns.push(String(solution.stats.solutions));
+    columns.push((solution.stats.solutions / seconds).toFixed(1));
+  }
+
+  console.log(columns.join('\t'));
+}
+
+
+// Runs one solve after the other: concurrent solves would compete for cores
+var runs = [];
+
+sizes.forEach(function(numNodes) {
+  variants.forEach(function(variant) {
+    runs.push({numNodes: numNodes, variant: variant});
+  });
+});
+
+console.log(['nodes', 'matrices', 'memory KiB', 'cost', 'solutions', 'solutions/s'].join('\t'));
+
+(function next(at) {
+  if (at === runs.length)
+    return;
+
+  var run = runs[at];
+  var generated = generate(run.numNodes, run.variant);
+
+  var searchOpts = Object.assign({computeTimeLimit: computeTimeLimit}, generated.searchOptions);
+
+  generated.vrp.Solve(searchOpts, function(err, solution) {
+    report(run.numNodes, run.variant, generated, err, solution);
+    next(at + 1);
+  });
+})(0);
@@ -0,0 +1,159 @@
+#!/usr/bin/env node
+
+'use strict';
+
+// Pickup and delivery with time windows (PDPTW) benchmark.
+//
+// Solves seeded random instances once per pickup and delivery variant and
+// reports the final cost and how many solutions per second the search found.
+//
+// Usage: node bench/pdptw.js [numPairs ..]
+
+var ortools = require('../');
+
+
+// Shorter runs e.g. for collecting profiles, see scripts/build-pgo.sh
+var computeTimeLimit = Number(process.env.BENCH_TIME_LIMIT) || 5000;
+var vehicleCapacity = 4;
+var timeHorizon = 10 * 60 * 60;
+var seed = 42;
+
+var variants = [
+  {name: 'constraints', pickupDeliveryMode: 'constraints'},
+  {name: 'paths', pickupDeliveryMode: 'paths'},
+  {name: 'paths lifo', pickupDeliveryMode: 'paths', pickupDeliveryOrder: 'lifo'},
+  {name: 'paths fifo', pickupDeliveryMode: 'paths', pickupDeliveryOrder: 'fifo'}
+];
+
+var sizes = process.argv.slice(2).map(Number);
+
+if (sizes.length === 0)
+  sizes = [25, 50, 100];
+
+
+// Deterministic instances across runs and machines
+function makeRandom(seed) {
+  var state = seed >>> 0;
+
+  return function() {
+    state = (Math.imul(state, 1664525) + 1013904223) >>> 0;
+    return state / 4294967296;
+  };
+}
+
+// Depot at node 0, then pairs of pickup and delivery nodes
+function makeInstance(numPairs, random) {
+  var numNodes = 1 + 2 * numPairs;
+
+  var points = [[0.5, 0.5]];
+
+  for (var i = 1; i < numNodes; ++i)
+    points.push([random(), random()]);
+
+  // Coordinates in the unit square, durations in seconds
+  var durations = points.map(function(from) {
+    return points.map(function(to) {
+      return Math.round(3600 * Math.hypot(from[0] - to[0], from[1] - to[1]));
+    });
+  });
+
+  var timeWindows = [[0, timeHorizon]];
+  var demands = [new Array(numNodes).fill(0)];
+  var pickups = [];
+  var deliveries = [];
+
+  for (var pair = 0; pair < numPairs; ++pair) {
+    var pickup = 1 + 2 * pair;
+    var delivery = pickup + 1;
+
+    var earliest = Math.floor(random() * timeHorizon / 2);
+    var latest = earliest + durations[pickup][delivery] + 2 * 3600;
+
+    timeWindows.push([earliest, earliest + 2 * 3600]);
+    timeWindows.push([earliest, Math.min(latest, timeHorizon)]);
+
+    demands.push(new Array(numNodes).fill(1));
+    demands.push(new Array(numNodes).fill(-1));
+
+    pickups.push(pickup);
+    deliveries.push(delivery);
+  }
+
+  return {
+    numNodes: numNodes,
+    costs: durations,
+    durations: durations,
+    timeWindows: timeWindows,
+    demands: demands,
+    pickups: pickups,
+    deliveries: deliveries
+  };
+}
+
+function solve(instance, variant, callback) {
+  var VRP = new ortools.VRP({
+    numNodes: instance.numNodes,
+    costs: instance.costs,
+    durations: instance.durations,
+    timeWindows: instance.timeWindows,
+    demands: instance.demands
+  });
+
+  var numVehicles = instance.pickups.length;
+
+  VRP.Solve({
+    computeTimeLimit: computeTimeLimit,
+    numVehicles: numVehicles,
+    depotNode: 0,
+    timeHorizon: timeHorizon,
+    vehicleCapacities: new Array(numVehicles).fill(vehicleCapacity),
+    routeLocks: new Array(numVehicles).fill([]),
+    pickups: instance.pickups,
+    deliveries: instance.deliveries,
+    pickupDeliveryMode: variant.pickupDeliveryMode,
+    pickupDeliveryOrder: variant.pickupDeliveryOrder
+  }, callback);
+}
+
+function report(numPairs, variant, err, solution) {
+  var columns = [String(numPairs), variant.name];
+
+  if (err) {
+    columns.push(err.message);
+  } else {
+    var seconds = Math.max(solution.stats.wallTime, 1) / 1000;
+    var used = solution.routes.filter(function(route) { return route.length > 0; }).length;
+
+    columns.push(String(solution.cost));
+    columns.push(String(used));
+    columns.push(String(solution.stats.solutions));
+    columns.push((solution.stats.solutions / seconds).toFixed(1));
+  }
+
+  console.log(columns.join('\t'));
+}
+
+
+// Runs one solve after the other: concurrent solves would compete for cores
+var runs = [];
+
+sizes.forEach(function(numPairs) {
+  variants.forEach(function(variant) {
+    runs.push({numPairs: numPairs, variant: variant});
+  });
+});
+
+console.log(['pairs', 'variant', 'cost', 'vehicles', 'solutions', 'solutions/s'].join('\t'));
+
+(function next(at) {
+  if (at === runs.length)
+    return;
+
+  var run = runs[at];
+  var instance = makeInstance(run.numPairs, makeRandom(seed + run.numPairs));
+
+  solve(instance, run.variant, function(err, solution) {
+    report(run.numPairs, run.variant, err, solution);
+    next(at + 1);
+  });
+})(0);
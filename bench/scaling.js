@@ -0,0 +1,93 @@
+#!/usr/bin/env node
+
+'use strict';
+
+// Scaling benchmark on generated instances.
+//
+// Generates seeded Solomon-style instances natively (see VRP.generate) per
+// layout and size and reports how long generating took, the final cost and
+// how many solutions per second the search found.
+//
+// Usage: node bench/scaling.js [numNodes ..]
+
+var ortools = require('../');
+
+
+// Shorter runs e.g. for collecting profiles, see scripts/build-pgo.sh
+var computeTimeLimit = Number(process.env.BENCH_TIME_LIMIT) || 5000;
+var customersPerVehicle = 10;
+var windowTightness = 0.5;
+var capacityTightness = 0.8;
+var seed = 42;
+
+var layouts = ['random', 'clustered', 'mixed'];
+
+var sizes = process.argv.slice(2).map(Number);
+
+if (sizes.length === 0)
+  sizes = [100, 200, 400, 800];
+
+
+function generate(numNodes, layout) {
+  var start = process.hrtime();
+
+  var generated = ortools.VRP.generate({
+    numNodes: numNodes,
+    numVehicles: Math.max(1, Math.ceil((numNodes - 1) / customersPerVehicle)),
+    layout: layout,
+    windowTightness: windowTightness,
+    capacityTightness: capacityTightness,
+    seed: seed + numNodes
+  });
+
+  var elapsed = process.hrtime(start);
+
+  generated.generateTime = elapsed[0] * 1000 + elapsed[1] / 1e6;
+
+  return generated;
+}
+
+function report(numNodes, layout, generated, err, solution) {
+  var columns = [String(numNodes), layout, generated.generateTime.toFixed(1)];
+
+  if (err) {
+    columns.push(err.message);
+  } else {
+    var seconds = Math.max(solution.stats.wallTime, 1) / 1000;
+    var used = solution.routes.filter(function(route) { return route.length > 0; }).length;
+
+    columns.push(String(solution.cost));
+    columns.push(String(used));
+    columns.push(String(solution.stats.solutions));
+    columns.push((solution.stats.solutions / seconds).toFixed(1));
+  }
+
+  console.log(columns.join('\t'));
+}
+
+
+// Runs one solve after the other: concurrent solves would compete for cores
+var runs = [];
+
+sizes.forEach(function(numNodes) {
+  layouts.forEach(function(layout) {
+    runs.push({numNodes: numNodes, layout: layout});
+  });
+});
+
+console.log(['nodes', 'layout', 'generate ms', 'cost', 'vehicles', 'solutions', 'solutions/s'].join('\t'));
+
+(function next(at) {
+  if (at === runs.length)
+    return;
+
+  var run = runs[at];
+  var generated = generate(run.numNodes, run.layout);
+
+  var searchOpts = Object.assign({computeTimeLimit: computeTimeLimit}, generated.searchOptions);
+
+  generated.vrp.Solve(searchOpts, function(err, solution) {
+    report(run.numNodes, run.layout, generated, err, solution);
+    next(at + 1);
+  });
+})(0);
@@ -36,8 +36,11 @@
             },
             'sources': [
                 'src/main.cc',
+                'src/scheduler.cc',
                 'src/tsp.cc',
                 'src/vrp.cc',
+                'src/vrp_search_config.cc',
+                'src/vrp_stream.cc',
             ],
             'ldflags': [
                 '-Wl,-z,now'
@@ -64,5 +67,20 @@
                 'GCC_VERSION': 'com.apple.compilers.llvm.clang.1_0'
             }
         },
+        {
+            # Native codec checks run from test/compressed_tiles.js; header only, no or-tools
+            'target_name': 'compressed_tiles_test',
+            'type': 'executable',
+            'include_dirs': [ 'src' ],
+            'sources': [
+                'test/native/compressed_tiles.cc',
+            ],
+            'xcode_settings': {
+                'GCC_ENABLE_CPP_EXCEPTIONS': 'YES',
+                'MACOSX_DEPLOYMENT_TARGET':'10.8',
+                'CLANG_CXX_LIBRARY': 'libc++',
+                'CLANG_CXX_LANGUAGE_STANDARD':'c++14'
+            }
+        },
     ],
 }
@@ -1 +1,77 @@
-module.exports = require('./binding/node_or_tools.node');
+var ortools = require('./binding/node_or_tools.node');
+
+
+// Builds a VRP from a binary instance of little-endian int32 sections, see API.md.
+// Reads file descriptors on a worker thread, decodes Readable chunks as they arrive.
+ortools.VRP.fromStream = function(source, opts, callback) {
+  if (typeof source === 'number')
+    return ortools.VRP.fromFd(source, opts, callback);
+
+  var stream;
+
+  try {
+    stream = new ortools.VRP.Stream(opts);
+  } catch (err) {
+    return process.nextTick(callback, err);
+  }
+
+  // Three matrices plus [start, stop] pairs per node, no matter the layout order
+  var totalBytes = 4 * (3 * opts.numNodes * opts.numNodes + 2 * opts.numNodes);
+
+  var finished = false;
+
+  function finish(err, vrp) {
+    if (finished) return;
+    finished = true;
+
+    source.removeListener('data', onData);
+    source.removeListener('end', onEnd);
+    source.removeListener('error', finish);
+
+    // Failed: stop reading the rest of the instance
+    if (err) {
+      if (typeof source.destroy === 'function')
+        source.destroy();
+      else
+        source.pause();
+    }
+
+    callback(err, vrp);
+  }
+
+  function onData(chunk) {
+    var bytesDecoded;
+
+    try {
+      bytesDecoded = stream.Write(chunk);
+    } catch (err) {
+      return finish(err);
+    }
+
+    if (typeof opts.onProgress === 'function')
+      opts.onProgress(bytesDecoded, totalBytes);
+  }
+
+  function onEnd() {
+    var vrp;
+
+    try {
+      vrp = stream.End();
+    } catch (err) {
+      return finish(err);
+    }
+
+    finish(null, vrp);
+  }
+
+  source.on('data', onData);
+  source.on('end', onEnd);
+  source.on('error', finish);
+};
+
+
+// Solves one VRP on several processes sharing their best solutions over a Unix domain socket, see API.md.
+ortools.VRP.portfolio = require('./portfolio');
+
+
+module.exports = ortools;
@@ -0,0 +1,229 @@
+var childProcess = require('child_process');
+var fs = require('fs');
+var net = require('net');
+var os = require('os');
+var path = require('path');
+
+
+// Solves one VRP on several processes at once, see API.md.
+//
+// The coordinator listens on a Unix domain socket and forks solver processes (portfolio_worker.js) connecting to it.
+// Every process gets the instance once, as binary snapshot for VRP.fromStream, and searches in slices of syncInterval
+// milliseconds: after every slice it reports its solution, the coordinator hands the best one to all other processes
+// and they continue their next slice from the best solution they know of.
+//
+// Messages are frames of a little-endian uint32 length, followed by a kind byte and the payload.
+
+var kMessage = 1;  // JSON payload
+var kInstance = 2; // Binary instance payload
+
+var kUnbounded = 2147483647; // Time window stop for instances without time windows
+
+// One first solution strategy per process, for searches starting out from different places
+var kStrategies = ['PATH_CHEAPEST_ARC', 'SAVINGS', 'PARALLEL_CHEAPEST_INSERTION', 'LOCAL_CHEAPEST_INSERTION',
+                   'GLOBAL_CHEAPEST_ARC', 'CHRISTOFIDES', 'PATH_MOST_CONSTRAINED_ARC', 'LOCAL_CHEAPEST_ARC'];
+
+var portfolios = 0;
+
+
+function encodeFrame(kind, payload) {
+  var header = Buffer.alloc(5);
+
+  header.writeUInt32LE(payload.length + 1, 0);
+  header.writeUInt8(kind, 4);
+
+  return Buffer.concat([header, payload]);
+}
+
+function encodeMessage(message) {
+  return encodeFrame(kMessage, Buffer.from(JSON.stringify(message)));
+}
+
+// Calls onFrame(kind, payload) for every frame, no matter how the socket chunks them
+function decodeFrames(socket, onFrame) {
+  var pending = Buffer.alloc(0);
+
+  socket.on('data', function(chunk) {
+    pending = Buffer.concat([pending, chunk]);
+
+    while (pending.length >= 4 && pending.length >= 4 + pending.readUInt32LE(0)) {
+      var length = pending.readUInt32LE(0);
+
+      onFrame(pending.readUInt8(4), pending.slice(5, 4 + length));
+
+      pending = pending.slice(4 + length);
+    }
+  });
+}
+
+// Only the sections of VRP.fromStream's default layout get to the processes: reject everything else up front
+function checkInstance(instance, searchOpts) {
+  if (instance.resources !== undefined || searchOpts.resourceCapacities !== undefined)
+    throw new Error('portfolio does not support resources and resourceCapacities');
+
+  if (instance.distances !== undefined)
+    throw new Error('portfolio does not support distances');
+
+  if (instance.durations !== undefined && !Array.isArray(instance.durations))
+    throw new Error('portfolio does not support durations depending on the departure time');
+}
+
+// Sections in VRP.fromStream's default layout: costs, durations, timeWindows, demands.
+// Absent durations and demands are left zero, which VRP.fromStream treats as absent; absent time windows are unbounded.
+function encodeInstance(instance) {
+  var n = instance.numNodes;
+  var snapshot = Buffer.alloc(4 * (3 * n * n + 2 * n));
+  var offset = 0;
+
+  function writeMatrix(matrix) {
+    if (matrix === undefined)
+      return (offset += 4 * n * n);
+
+    for (var from = 0; from < n; ++from)
+      for (var to = 0; to < n; ++to)
+        offset = snapshot.writeInt32LE(matrix[from][to], offset);
+  }
+
+  writeMatrix(instance.costs);
+  writeMatrix(instance.durations);
+
+  for (var node = 0; node < n; ++node) {
+    var timeWindow = instance.timeWindows !== undefined ? instance.timeWindows[node] : [0, kUnbounded];
+
+    offset = snapshot.writeInt32LE(timeWindow[0], offset);
+    offset = snapshot.writeInt32LE(timeWindow[1], offset);
+  }
+
+  writeMatrix(instance.demands);
+
+  return snapshot;
+}
+
+
+function portfolio(instance, searchOpts, opts, callback) {
+  var numProcesses = opts.processes || os.cpus().length;
+  var syncInterval = opts.syncInterval || 1000;
+
+  var snapshot;
+
+  try {
+    checkInstance(instance, searchOpts);
+    snapshot = encodeInstance(instance);
+  } catch (err) {
+    return process.nextTick(callback, err);
+  }
+
+  var socketPath = path.join(os.tmpdir(), 'node-or-tools-' + process.pid + '-' + (portfolios++) + '.sock');
+
+  var best = null;
+  var failure = null; // First error a process reported, for when there is no solution at all
+  var sockets = [];
+  var children = [];
+  var done = {};
+  var running = numProcesses;
+  var finished = false;
+
+  function processDone(id) {
+    if (done[id]) return;
+    done[id] = true;
+
+    if (--running === 0)
+      finish(null);
+  }
+
+  function finish(err) {
+    if (finished) return;
+    finished = true;
+
+    clearTimeout(timer);
+
+    children.forEach(function(child) { child.kill(); });
+    sockets.forEach(function(socket) { socket.destroy(); });
+
+    server.close(function() {
+      if (err)
+        return callback(err);
+
+      if (!best)
+        return callback(failure || new Error('Unable to find a solution'));
+
+      callback(null, best);
+    });
+  }
+
+  function onMessage(socket, message) {
+    if (message.type === 'hello') {
+      var strategy = kStrategies[message.id % kStrategies.length];
+
+      socket.write(encodeMessage({
+        type: 'setup',
+        numNodes: instance.numNodes,
+        compressMatrices: instance.compressMatrices,
+        searchOpts: Object.assign({}, searchOpts, {firstSolutionStrategies: [strategy]}),
+        syncInterval: syncInterval
+      }));
+
+      socket.write(encodeFrame(kInstance, snapshot));
+    }
+
+    if (message.type === 'solution' && (!best || message.solution.cost < best.cost)) {
+      best = message.solution;
+
+      var share = encodeMessage({type: 'best', cost: best.cost, routes: best.routes});
+
+      sockets.forEach(function(other) {
+        if (other !== socket)
+          other.write(share);
+      });
+    }
+
+    if (message.type === 'error' && !failure)
+      failure = new Error(message.message);
+
+    if (message.type === 'done' || message.type === 'error')
+      processDone(message.id);
+  }
+
+  var server = net.createServer(function(socket) {
+    sockets.push(socket);
+
+    // Processes going away are handled on their exit
+    socket.on('error', function() {});
+
+    decodeFrames(socket, function(kind, payload) {
+      if (kind === kMessage)
+        onMessage(socket, JSON.parse(payload.toString()));
+    });
+  });
+
+  // Backstop for processes which never report back
+  var timer = setTimeout(function() { finish(new Error('Portfolio processes did not finish in time')); },
+                         searchOpts.computeTimeLimit + 10 * 1000);
+
+  server.on('error', finish);
+
+  // Left behind by a process which had the same pid before
+  try {
+    fs.unlinkSync(socketPath);
+  } catch (err) {}
+
+  server.listen(socketPath, function() {
+    for (var id = 0; id < numProcesses; ++id) {
+      var child = childProcess.fork(path.join(__dirname, 'portfolio_worker.js'), [socketPath, String(id)]);
+
+      // Processes failing before they are done, e.g. on invalid search options, do not hold up the others
+      child.on('exit', processDone.bind(null, id));
+
+      children.push(child);
+    }
+  });
+}
+
+
+module.exports = portfolio;
+
+module.exports.kMessage = kMessage;
+module.exports.kInstance = kInstance;
+module.exports.encodeFrame = encodeFrame;
+module.exports.encodeMessage = encodeMessage;
+module.exports.decodeFrames = decodeFrames;
@@ -0,0 +1,97 @@
+var net = require('net');
+var stream = require('stream');
+
+var ortools = require('./index');
+var portfolio = require('./portfolio');
+
+
+// Solver process of a portfolio, forked by portfolio.js with the coordinator's socket path and the process' id.
+// Searches in slices, continuing every slice from the best solution known: its own or one the coordinator shared.
+
+var socketPath = process.argv[2];
+var id = Number(process.argv[3]);
+
+var socket = net.connect(socketPath);
+
+var setup = null;
+var known = null; // {cost, routes}
+var deadline = 0;
+
+
+function send(message) {
+  socket.write(portfolio.encodeMessage(message));
+}
+
+// Tells the coordinator why this process has nothing to report, e.g. invalid search options
+function fail(err) {
+  send({type: 'error', id: id, message: err.message});
+  socket.end();
+}
+
+// A slice without solution is no failure while there is time left: the next one searches for longer
+function solveSlice(vrp, lastError) {
+  var remaining = deadline - Date.now();
+
+  if (remaining <= 0) {
+    if (!known && lastError)
+      return fail(lastError);
+
+    send({type: 'done', id: id});
+    return socket.end();
+  }
+
+  var searchOpts = Object.assign({}, setup.searchOpts, {computeTimeLimit: Math.min(setup.syncInterval, remaining)});
+
+  if (known)
+    searchOpts.initialRoutes = known.routes;
+
+  try {
+    vrp.Solve(searchOpts, function(err, solution) {
+      if (!err && (!known || solution.cost < known.cost)) {
+        known = {cost: solution.cost, routes: solution.routes};
+        send({type: 'solution', id: id, solution: solution});
+      }
+
+      solveSlice(vrp, err);
+    });
+  } catch (err) {
+    fail(err);
+  }
+}
+
+function start(snapshot) {
+  var source = new stream.PassThrough();
+
+  ortools.VRP.fromStream(source, {numNodes: setup.numNodes, compressMatrices: setup.compressMatrices}, function(err, vrp) {
+    if (err)
+      return fail(err);
+
+    deadline = Date.now() + setup.searchOpts.computeTimeLimit;
+    solveSlice(vrp, null);
+  });
+
+  source.end(snapshot);
+}
+
+
+socket.on('connect', function() {
+  send({type: 'hello', id: id});
+});
+
+portfolio.decodeFrames(socket, function(kind, payload) {
+  if (kind === portfolio.kInstance)
+    return start(payload);
+
+  var message = JSON.parse(payload.toString());
+
+  if (message.type === 'setup')
+    setup = message;
+
+  if (message.type === 'best' && (!known || message.cost < known.cost))
+    known = {cost: message.cost, routes: message.routes};
+});
+
+// The coordinator went away: nothing left to search for
+socket.on('error', function() {
+  process.exit(1);
+});
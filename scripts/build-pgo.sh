@@ -0,0 +1,43 @@
+#!/usr/bin/env bash
+
+# Builds the opt-in release variant with link time optimization and profile guided optimization:
+#  1. standard release, benchmarked as the baseline
+#  2. instrumented release, profiles collected by running the benchmarks
+#  3. release optimized with the profiles, benchmarked against the baseline
+#
+# Only our translation units get optimized: libortools.a is prebuilt without LTO, calls into it stay as they are.
+# Needs gcc; set BENCH_TIME_LIMIT to milliseconds per solve for shorter runs.
+
+set -eu
+set -o pipefail
+
+PGO_DIR="$(pwd)/build/pgo"
+NODE_PRE_GYP="./node_modules/.bin/node-pre-gyp"
+
+export BENCH_TIME_LIMIT=${BENCH_TIME_LIMIT:-2000}
+
+rm -rf ${PGO_DIR}
+mkdir -p ${PGO_DIR}/profiles
+
+function bench() {
+  node bench/pdptw.js > ${PGO_DIR}/pdptw-$1.tsv
+  node bench/scaling.js > ${PGO_DIR}/scaling-$1.tsv
+}
+
+echo "Building and benchmarking the standard release"
+${NODE_PRE_GYP} rebuild --build-from-source
+bench standard
+
+echo "Collecting profiles with an instrumented release"
+${NODE_PRE_GYP} rebuild --build-from-source -- --lto=true --pgo=generate --pgo_dir=${PGO_DIR}/profiles
+bench instrumented
+
+echo "Building and benchmarking the optimized release"
+${NODE_PRE_GYP} rebuild --build-from-source -- --lto=true --pgo=use --pgo_dir=${PGO_DIR}/profiles
+bench optimized
+
+echo "Speedup of the optimized release over the standard release"
+
+for name in pdptw scaling; do
+  node bench/compare.js ${PGO_DIR}/${name}-standard.tsv ${PGO_DIR}/${name}-optimized.tsv
+done
@@ -17,6 +17,27 @@ template <typename T> auto makeUnaryAdaptor(const T& v) {
   return [&](NodeIndex idx) -> int64 { return v.at(idx.value()); };
 }
 
+// Matrix to operator()(NodeIndex, NodeIndex) for models with copies of the depot past the matrix, e.g. reload stops.
+// Copies get remapped onto the depot on the fly instead of growing the matrix. Empty matrices are zero everywhere.
+template <typename T> auto makeDepotCopiesAdaptor(const T& m, std::int32_t depot) {
+  return [&m, depot](NodeIndex from, NodeIndex to) -> int64 {
+    const auto n = m.dim();
+
+    if (n == 0)
+      return 0;
+
+    return m.at(from.value() < n ? from.value() : depot, to.value() < n ? to.value() : depot);
+  };
+}
+
+// As above but arcs leaving depot copies carry `leaving` instead, e.g. a negative demand emptying the vehicle.
+template <typename T> auto makeDepotCopiesAdaptor(const T& m, std::int32_t depot, int64 leaving) {
+  return [&m, depot, leaving](NodeIndex from, NodeIndex to) -> int64 {
+    const auto n = m.dim();
+    return from.value() < n ? m.at(from.value(), to.value() < n ? to.value() : depot) : leaving;
+  };
+}
+
 // Adaptors to callback. Note: ownership is bound to the underlying storage.
 template <typename Adaptor> auto makeCallback(const Adaptor& adaptor) {
   return NewPermanentCallback(&adaptor, &Adaptor::operator());
@@ -0,0 +1,146 @@
+#ifndef NODE_OR_TOOLS_COMPRESSED_TILES_5A0E3D9B71C2_H
+#define NODE_OR_TOOLS_COMPRESSED_TILES_5A0E3D9B71C2_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+// Read-only n x n storage split into 64 x 64 tiles. Each tile stores its minimum value plus
+// bitpacked deltas to it using the smallest bit width covering the tile's value range.
+// Lookups unpack the single value asked for: one or two word loads, no matter the access order.
+template <typename T> class CompressedTiles {
+public:
+  using Value = T;
+
+  static constexpr std::int32_t kTileDim = 64;
+
+  CompressedTiles(std::int32_t n_, const std::vector<T>& data) : n{n_}, tilesPerDim{(n_ + kTileDim - 1) / kTileDim} {
+    static_assert(std::is_integral<T>::value && sizeof(T) <= 4, "CompressedTiles<T> requires T to be integral up to 32 bits");
+
+    if (n < 0 || static_cast<std::size_t>(n) * n != data.size())
+      throw std::runtime_error{"Compressed tiles dimension do not match data size"};
+
+    tiles.resize(tilesPerDim * tilesPerDim);
+
+    for (std::int32_t ty = 0; ty < tilesPerDim; ++ty)
+      for (std::int32_t tx = 0; tx < tilesPerDim; ++tx)
+        encode(tx, ty, data);
+
+    words.shrink_to_fit();
+  }
+
+  std::int32_t dim() const { return n; }
+
+  std::int32_t bytes() const { return words.size() * sizeof(std::uint64_t) + tiles.size() * sizeof(Tile); }
+
+  T at(std::int32_t x, std::int32_t y) const {
+    if (x < 0 || y < 0 || x >= n || y >= n)
+      throw std::out_of_range{"Compressed tiles index out of range"};
+
+    const auto& tile = tiles[(y / kTileDim) * tilesPerDim + (x / kTileDim)];
+
+    return unpack(tile, (y % kTileDim) * tile.cols + (x % kTileDim));
+  }
+
+  // Decompresses all tiles back into a row-major y * n + x vector
+  std::vector<T> decompress() const {
+    std::vector<T> data(static_cast<std::size_t>(n) * n);
+
+    for (std::int32_t y = 0; y < n; ++y)
+      for (std::int32_t x = 0; x < n; ++x)
+        data[static_cast<std::size_t>(y) * n + x] = at(x, y);
+
+    return data;
+  }
+
+private:
+  struct Tile {
+    T base;
+    std::uint8_t width;
+    std::uint8_t cols;
+    std::uint8_t rows;
+    std::uint32_t offset;
+  };
+
+  void encode(std::int32_t tx, std::int32_t ty, const std::vector<T>& data) {
+    const auto x0 = tx * kTileDim;
+    const auto y0 = ty * kTileDim;
+    const auto cols = std::min(kTileDim, n - x0);
+    const auto rows = std::min(kTileDim, n - y0);
+
+    auto lo = data[static_cast<std::size_t>(y0) * n + x0];
+    auto hi = lo;
+
+    for (std::int32_t y = y0; y < y0 + rows; ++y) {
+      for (std::int32_t x = x0; x < x0 + cols; ++x) {
+        const auto v = data[static_cast<std::size_t>(y) * n + x];
+        lo = std::min(lo, v);
+        hi = std::max(hi, v);
+      }
+    }
+
+    const auto range = static_cast<std::uint64_t>(static_cast<std::int64_t>(hi) - static_cast<std::int64_t>(lo));
+
+    std::uint8_t width = 0;
+    while (width < 64 && (range >> width) != 0)
+      width += 1;
+
+    if (words.size() > UINT32_MAX)
+      throw std::runtime_error{"Compressed tiles exceed addressable size"};
+
+    Tile& tile = tiles[ty * tilesPerDim + tx];
+    tile.base = lo;
+    tile.width = width;
+    tile.cols = cols;
+    tile.rows = rows;
+    tile.offset = words.size();
+
+    words.resize(words.size() + (static_cast<std::size_t>(cols) * rows * width + 63) / 64, 0);
+
+    std::size_t bit = static_cast<std::size_t>(tile.offset) * 64;
+
+    for (std::int32_t y = y0; y < y0 + rows; ++y) {
+      for (std::int32_t x = x0; x < x0 + cols; ++x, bit += width) {
+        if (width == 0)
+          continue;
+
+        const auto v = data[static_cast<std::size_t>(y) * n + x];
+        const auto delta = static_cast<std::uint64_t>(static_cast<std::int64_t>(v) - static_cast<std::int64_t>(lo));
+
+        words[bit / 64] |= delta << (bit % 64);
+
+        if (bit % 64 + width > 64)
+          words[bit / 64 + 1] |= delta >> (64 - bit % 64);
+      }
+    }
+  }
+
+  // Unpacks the value at index in the tile's row-major cols stride: bit offset * 64 + index * width
+  T unpack(const Tile& tile, std::int32_t index) const {
+    if (tile.width == 0)
+      return tile.base;
+
+    const auto bit = static_cast<std::size_t>(tile.offset) * 64 + static_cast<std::size_t>(index) * tile.width;
+    const std::uint64_t mask = tile.width == 64 ? ~std::uint64_t{0} : (std::uint64_t{1} << tile.width) - 1;
+
+    auto delta = words[bit / 64] >> (bit % 64);
+
+    if (bit % 64 + tile.width > 64)
+      delta |= words[bit / 64 + 1] << (64 - bit % 64);
+
+    return static_cast<T>(static_cast<std::int64_t>(tile.base) + static_cast<std::int64_t>(delta & mask));
+  }
+
+  std::int32_t n;
+  std::int32_t tilesPerDim;
+
+  std::vector<Tile> tiles;
+  std::vector<std::uint64_t> words;
+};
+
+template <typename T> constexpr std::int32_t CompressedTiles<T>::kTileDim;
+
+#endif
@@ -0,0 +1,608 @@
+#ifndef NODE_OR_TOOLS_CONSTRUCT_3F8B2D6A0E71_H
+#define NODE_OR_TOOLS_CONSTRUCT_3F8B2D6A0E71_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "types.h"
+
+// Which search solves a VRP:
+//  - Routing: or-tools' RoutingModel with all of its constraints
+//  - Construct: native savings construction plus a short local search polish, for instant preview plans
+enum class SearchEngine { Routing, Construct };
+
+inline SearchEngine makeSearchEngineFromName(const std::string& name) {
+  if (name == "routing")
+    return SearchEngine::Routing;
+  if (name == "construct")
+    return SearchEngine::Construct;
+
+  throw std::runtime_error{"Expected engine of 'routing' or 'construct'"};
+}
+
+// Clarke-Wright savings on the cost matrix, followed by 2-opt and Or-opt moves until the deadline.
+// Works on costs, durations, time windows, demands and capacities directly: no model to set up.
+//  - Routes start at time zero and wait for time windows to open, like the routing engine does
+//  - Empty durations, time windows, demands or capacities constrain nothing
+// Routes hold nodes without the depot, one route per vehicle.
+class SavingsConstruction {
+public:
+  using Route = std::vector<std::int32_t>;
+
+  SavingsConstruction(std::int32_t numNodes_, std::int32_t numVehicles_, std::int32_t depot_, std::int32_t timeHorizon_,
+                      const CostMatrix& costs_, const DurationMatrix& durations_, const TimeWindows& timeWindows_,
+                      const DemandMatrix& demands_, const std::vector<int64>& vehicleCapacities_)
+      : numNodes{numNodes_},
+        numVehicles{numVehicles_},
+        depot{depot_},
+        timeHorizon{timeHorizon_},
+        costs(costs_),
+        durations(durations_),
+        timeWindows(timeWindows_),
+        demands(demands_),
+        vehicleCapacities(vehicleCapacities_) {}
+
+  // False if the plan does not fit the vehicles
+  bool solve(std::chrono::steady_clock::time_point deadline) {
+    if (!construct(deadline))
+      return false;
+
+    if (!assignVehicles())
+      return false;
+
+    polish(deadline);
+
+    return true;
+  }
+
+  const std::vector<Route>& routes() const { return plan; }
+
+  // Local search moves accepted while polishing
+  std::int64_t improvements() const { return moves; }
+
+  std::int64_t cost(const Route& route) const {
+    std::int64_t sum = 0;
+
+    for (const auto arcCost : arcCosts(route))
+      sum += arcCost;
+
+    return sum;
+  }
+
+  // Per arc including the way back to the depot; zero for unused vehicles as in the routing engine
+  std::vector<std::int64_t> arcCosts(const Route& route) const {
+    if (route.empty())
+      return {0};
+
+    std::vector<std::int64_t> arcs;
+    auto previous = depot;
+
+    for (const auto node : route) {
+      arcs.push_back(costs.at(previous, node));
+      previous = node;
+    }
+
+    arcs.push_back(costs.at(previous, depot));
+
+    return arcs;
+  }
+
+  // Earliest arrival and latest arrival still making it back in time, per node
+  std::vector<Interval> times(const Route& route) const {
+    std::vector<std::int64_t> earliest(route.size());
+    std::vector<std::int64_t> latest(route.size());
+
+    std::int64_t arrival = 0;
+    auto previous = depot;
+
+    for (std::size_t atIdx = 0; atIdx < route.size(); ++atIdx) {
+      arrival = std::max(arrival + duration(previous, route[atIdx]), windowStart(route[atIdx]));
+      earliest[atIdx] = arrival;
+      previous = route[atIdx];
+    }
+
+    auto departure = routeEnd();
+    auto next = depot;
+
+    for (std::size_t atIdx = route.size(); atIdx > 0; --atIdx) {
+      departure = std::min(departure - duration(route[atIdx - 1], next), windowStop(route[atIdx - 1]));
+      latest[atIdx - 1] = departure;
+      next = route[atIdx - 1];
+    }
+
+    std::vector<Interval> routeTimes;
+
+    for (std::size_t atIdx = 0; atIdx < route.size(); ++atIdx)
+      routeTimes.push_back(Interval{static_cast<std::int32_t>(earliest[atIdx]), static_cast<std::int32_t>(latest[atIdx])});
+
+    return routeTimes;
+  }
+
+private:
+  // No latest departure from the depot; leaves room for subtracting durations without overflowing
+  static constexpr std::int64_t kUnbounded = std::numeric_limits<std::int64_t>::max() / 4;
+
+  // Concatenable summary of consecutive route nodes, for checking moves in constant time instead of walking routes:
+  //  - loads after every arc relative to the first node: in total, the lowest and the highest
+  //  - arrival at the last node as max(arrival at the first node + duration, earliest), if arriving by latest
+  struct Stretch {
+    std::int32_t first;
+    std::int32_t last;
+    std::int64_t load;
+    std::int64_t minLoad;
+    std::int64_t maxLoad;
+    std::int64_t duration;
+    std::int64_t earliest;
+    std::int64_t latest;
+    bool reachable; // False if a time window closes before the vehicle can get there
+  };
+
+  Stretch visit(std::int32_t node) const { return Stretch{node, node, 0, 0, 0, 0, windowStart(node), windowStop(node), true}; }
+
+  // Vehicles leave the depot at time zero and are back by the end of the depot's time window
+  Stretch routeStart() const { return Stretch{depot, depot, 0, 0, 0, 0, 0, kUnbounded, true}; }
+  Stretch routeStop() const { return Stretch{depot, depot, 0, 0, 0, 0, 0, routeEnd(), true}; }
+
+  Stretch join(const Stretch& lhs, const Stretch& rhs) const {
+    const auto travel = duration(lhs.last, rhs.first);
+    const auto load = lhs.load + demand(lhs.last, rhs.first);
+
+    return Stretch{lhs.first,
+                   rhs.last,
+                   load + rhs.load,
+                   std::min(lhs.minLoad, load + rhs.minLoad),
+                   std::max(lhs.maxLoad, load + rhs.maxLoad),
+                   lhs.duration + travel + rhs.duration,
+                   std::max(lhs.earliest + travel + rhs.duration, rhs.earliest),
+                   std::min(lhs.latest, rhs.latest - travel - lhs.duration),
+                   lhs.reachable && rhs.reachable && lhs.earliest + travel <= rhs.latest};
+  }
+
+  // Loads stay within [0, capacity] after every arc and every node is reached within its time window,
+  // for a stretch from routeStart() to routeStop()
+  bool fits(const Stretch& route, std::int64_t routeCapacity) const {
+    return route.reachable && route.latest >= 0 && route.minLoad >= 0 && route.maxLoad <= routeCapacity;
+  }
+
+  bool feasible(const Route& route, std::int64_t routeCapacity) const {
+    auto stretch = routeStart();
+
+    for (const auto node : route)
+      stretch = join(stretch, visit(node));
+
+    return fits(join(stretch, routeStop()), routeCapacity);
+  }
+
+  // Savings per node are kept for its nearest predecessors only: merging far apart nodes hardly ever saves anything,
+  // and sorting all n^2 savings alone takes longer than a preview may at a few thousand nodes
+  static constexpr std::size_t kNeighbours = 32;
+
+  // Merging the route ending in from with the route starting in to saves c(from, depot) + c(depot, to) - c(from, to)
+  struct Saving {
+    std::int64_t value;
+    std::int32_t from;
+    std::int32_t to;
+  };
+
+  Saving saving(std::int32_t from, std::int32_t to) const {
+    return Saving{arcCost(from, depot) + arcCost(depot, to) - arcCost(from, to), from, to};
+  }
+
+  // Largest savings first, ties in node order
+  static bool larger(const Saving& lhs, const Saving& rhs) {
+    return std::tie(rhs.value, lhs.from, lhs.to) < std::tie(lhs.value, rhs.from, rhs.to);
+  }
+
+  // Per node the savings from its kNeighbours nearest predecessors, kept in a max-heap on their cost while scanning.
+  // Nodes not reached by the deadline get none of their own.
+  std::vector<Saving> neighbourSavings(std::chrono::steady_clock::time_point deadline) const {
+    std::vector<Saving> savings;
+    std::vector<std::pair<std::int64_t, std::int32_t>> nearest;
+
+    for (std::int32_t to = 0; to < numNodes && std::chrono::steady_clock::now() < deadline; ++to) {
+      if (to == depot)
+        continue;
+
+      nearest.clear();
+
+      for (std::int32_t from = 0; from < numNodes; ++from) {
+        if (from == to || from == depot)
+          continue;
+
+        const auto candidate = std::make_pair(arcCost(from, to), from);
+
+        if (nearest.size() < kNeighbours) {
+          nearest.push_back(candidate);
+          std::push_heap(nearest.begin(), nearest.end());
+        } else if (candidate < nearest.front()) {
+          std::pop_heap(nearest.begin(), nearest.end());
+          nearest.back() = candidate;
+          std::push_heap(nearest.begin(), nearest.end());
+        }
+      }
+
+      for (const auto& neighbour : nearest)
+        savings.push_back(saving(neighbour.second, to));
+    }
+
+    std::sort(savings.begin(), savings.end(), larger);
+
+    return savings;
+  }
+
+  // Savings from every route's last node to every other route's first node. Merges only ever join existing ends,
+  // so these are all merges left. None if the deadline passes while collecting them.
+  std::vector<Saving> endSavings(const std::vector<Route>& routes, std::chrono::steady_clock::time_point deadline) const {
+    std::vector<Saving> savings;
+
+    for (std::size_t tail = 0; tail < routes.size(); ++tail) {
+      if (routes[tail].empty())
+        continue;
+
+      if (std::chrono::steady_clock::now() >= deadline)
+        return {};
+
+      for (std::size_t head = 0; head < routes.size(); ++head)
+        if (head != tail && !routes[head].empty())
+          savings.push_back(saving(routes[tail].back(), routes[head].front()));
+    }
+
+    std::sort(savings.begin(), savings.end(), larger);
+
+    return savings;
+  }
+
+  // Every node on its own route, then merging routes by decreasing savings: first from nearest predecessors, then
+  // between all route ends if routes still outnumber vehicles. Merges which save nothing only happen while routes
+  // outnumber vehicles. At the deadline merging stops with the routes so far, which fail if they outnumber the vehicles.
+  bool construct(std::chrono::steady_clock::time_point deadline) {
+    std::vector<Route> routes;
+    std::vector<Stretch> stretches;
+    std::vector<std::int32_t> routeOf(numNodes, -1);
+
+    for (std::int32_t node = 0; node < numNodes; ++node) {
+      if (node == depot)
+        continue;
+
+      if (!feasible(Route{node}, maxCapacity()))
+        return false;
+
+      routeOf[node] = routes.size();
+      routes.push_back(Route{node});
+      stretches.push_back(visit(node));
+    }
+
+    auto numRoutes = static_cast<std::int32_t>(routes.size());
+
+    const auto merge = [&](const std::vector<Saving>& savings) {
+      for (std::size_t atIdx = 0; atIdx < savings.size(); ++atIdx) {
+        const auto& saving = savings[atIdx];
+
+        if (saving.value <= 0 && numRoutes <= numVehicles)
+          return;
+
+        // Reading the clock costs more than trying a merge
+        if (atIdx % 1024 == 0 && std::chrono::steady_clock::now() >= deadline)
+          return;
+
+        const auto head = routeOf[saving.from];
+        const auto tail = routeOf[saving.to];
+
+        if (head == tail || routes[head].back() != saving.from || routes[tail].front() != saving.to)
+          continue;
+
+        const auto merged = join(stretches[head], stretches[tail]);
+
+        if (!fits(join(join(routeStart(), merged), routeStop()), maxCapacity()))
+          continue;
+
+        for (const auto node : routes[tail])
+          routeOf[node] = head;
+
+        routes[head].insert(routes[head].end(), routes[tail].begin(), routes[tail].end());
+        routes[tail].clear();
+        stretches[head] = merged;
+        numRoutes -= 1;
+      }
+    };
+
+    merge(neighbourSavings(deadline));
+
+    if (numRoutes > numVehicles)
+      merge(endSavings(routes, deadline));
+
+    if (numRoutes > numVehicles)
+      return false;
+
+    for (auto& route : routes)
+      if (!route.empty())
+        plan.push_back(std::move(route));
+
+    return true;
+  }
+
+  // Heaviest routes on the largest vehicles; the plan ends up with one route per vehicle
+  bool assignVehicles() {
+    std::vector<std::int32_t> vehicles(numVehicles);
+
+    for (std::int32_t vehicle = 0; vehicle < numVehicles; ++vehicle)
+      vehicles[vehicle] = vehicle;
+
+    std::stable_sort(vehicles.begin(), vehicles.end(),
+                     [&](std::int32_t lhs, std::int32_t rhs) { return capacity(lhs) > capacity(rhs); });
+
+    std::stable_sort(plan.begin(), plan.end(), [&](const Route& lhs, const Route& rhs) { return peakLoad(lhs) > peakLoad(rhs); });
+
+    std::vector<Route> assigned(numVehicles);
+
+    for (std::size_t atIdx = 0; atIdx < plan.size(); ++atIdx) {
+      if (!feasible(plan[atIdx], capacity(vehicles[atIdx])))
+        return false;
+
+      assigned[vehicles[atIdx]] = std::move(plan[atIdx]);
+    }
+
+    plan = std::move(assigned);
+
+    return true;
+  }
+
+  // First improvement 2-opt within routes and Or-opt moves of up to three nodes within and across routes.
+  // Moves are priced by their cost delta and checked against the stretches before and after them.
+  void polish(std::chrono::steady_clock::time_point deadline) {
+    heads.resize(numVehicles);
+    tails.resize(numVehicles);
+
+    for (std::int32_t vehicle = 0; vehicle < numVehicles; ++vehicle)
+      reindex(vehicle);
+
+    auto improved = true;
+
+    while (improved && std::chrono::steady_clock::now() < deadline) {
+      improved = false;
+
+      for (std::int32_t vehicle = 0; vehicle < numVehicles; ++vehicle)
+        improved = twoOpt(vehicle, deadline) || improved;
+
+      for (std::int32_t vehicle = 0; vehicle < numVehicles; ++vehicle)
+        improved = orOpt(vehicle, deadline) || improved;
+    }
+  }
+
+  // Stretches from the route start up to before each position and from each position to the route stop
+  void reindex(std::int32_t vehicle) {
+    const auto& route = plan[vehicle];
+
+    auto& head = heads[vehicle];
+    auto& tail = tails[vehicle];
+
+    head.assign(route.size() + 1, routeStart());
+    tail.assign(route.size() + 1, routeStop());
+
+    for (std::size_t at = 0; at < route.size(); ++at)
+      head[at + 1] = join(head[at], visit(route[at]));
+
+    for (std::size_t at = route.size(); at > 0; --at)
+      tail[at - 1] = join(visit(route[at - 1]), tail[at]);
+  }
+
+  // Reverses route[first..last]: with asymmetric costs the arcs in between change, too
+  bool twoOpt(std::int32_t vehicle, std::chrono::steady_clock::time_point deadline) {
+    auto& route = plan[vehicle];
+    const auto size = route.size();
+
+    for (std::size_t first = 0; first + 1 < size; ++first) {
+      if (std::chrono::steady_clock::now() >= deadline)
+        return false;
+
+      const auto before = first == 0 ? depot : route[first - 1];
+
+      auto reversed = visit(route[first]);
+      std::int64_t forward = 0;
+      std::int64_t backward = 0;
+
+      for (std::size_t last = first + 1; last < size; ++last) {
+        const auto after = last + 1 == size ? depot : route[last + 1];
+
+        forward += arcCost(route[last - 1], route[last]);
+        backward += arcCost(route[last], route[last - 1]);
+        reversed = join(visit(route[last]), reversed);
+
+        const auto delta = arcCost(before, route[last]) + arcCost(route[first], after) + backward //
+                           - arcCost(before, route[first]) - arcCost(route[last], after) - forward;
+
+        if (delta >= 0 || !fits(join(join(heads[vehicle][first], reversed), tails[vehicle][last + 1]), capacity(vehicle)))
+          continue;
+
+        std::reverse(route.begin() + first, route.begin() + last + 1);
+        reindex(vehicle);
+        moves += 1;
+        return true;
+      }
+    }
+
+    return false;
+  }
+
+  // Moves route[first..stop) in between two other nodes of the same route or of another route
+  bool orOpt(std::int32_t vehicle, std::chrono::steady_clock::time_point deadline) {
+    const auto& route = plan[vehicle];
+    const auto size = route.size();
+
+    for (std::size_t length = 1; length <= 3; ++length) {
+      for (std::size_t first = 0; first + length <= size; ++first) {
+        const auto stop = first + length;
+
+        auto segment = visit(route[first]);
+
+        for (auto at = first + 1; at < stop; ++at)
+          segment = join(segment, visit(route[at]));
+
+        const auto before = first == 0 ? depot : route[first - 1];
+        const auto after = stop == size ? depot : route[stop];
+
+        // Unused vehicles cost nothing, not the arc from the depot to the depot
+        const auto removal = (length == size ? 0 : arcCost(before, after)) //
+                             - arcCost(before, segment.first) - arcCost(segment.last, after);
+
+        const auto insertion = [&](std::int32_t from, std::int32_t to, bool empty) {
+          return arcCost(from, segment.first) + arcCost(segment.last, to) - (empty ? 0 : arcCost(from, to));
+        };
+
+        const auto sourceFits = fits(join(heads[vehicle][first], tails[vehicle][stop]), capacity(vehicle));
+
+        for (std::int32_t target = 0; target < numVehicles; ++target) {
+          if (std::chrono::steady_clock::now() >= deadline)
+            return false;
+
+          if (target == vehicle) {
+            if (moveWithin(vehicle, first, length, segment, removal, insertion))
+              return true;
+
+            continue;
+          }
+
+          const auto& base = plan[target];
+
+          for (std::size_t at = 0; sourceFits && at <= base.size(); ++at) {
+            const auto from = at == 0 ? depot : base[at - 1];
+            const auto to = at == base.size() ? depot : base[at];
+
+            if (removal + insertion(from, to, base.empty()) >= 0)
+              continue;
+
+            if (!fits(join(join(heads[target][at], segment), tails[target][at]), capacity(target)))
+              continue;
+
+            plan[target].insert(plan[target].begin() + at, route.begin() + first, route.begin() + stop);
+            plan[vehicle].erase(plan[vehicle].begin() + first, plan[vehicle].begin() + stop);
+            reindex(target);
+            reindex(vehicle);
+            moves += 1;
+            return true;
+          }
+        }
+      }
+    }
+
+    return false;
+  }
+
+  // Or-opt within a route: the nodes between the segment's old and new place get joined up one at a time
+  template <typename Insertion>
+  bool moveWithin(std::int32_t vehicle, std::size_t first, std::size_t length, const Stretch& segment, std::int64_t removal,
+                  const Insertion& insertion) {
+    auto& route = plan[vehicle];
+    const auto size = route.size();
+    const auto stop = first + length;
+
+    // Before the segment: route[at..first) moves behind it
+    if (first > 0) {
+      auto between = visit(route[first - 1]);
+
+      for (auto at = first; at > 0; --at) {
+        if (at < first)
+          between = join(visit(route[at - 1]), between);
+
+        const auto from = at == 1 ? depot : route[at - 2];
+
+        if (removal + insertion(from, route[at - 1], false) >= 0)
+          continue;
+
+        if (!fits(join(join(join(heads[vehicle][at - 1], segment), between), tails[vehicle][stop]), capacity(vehicle)))
+          continue;
+
+        std::rotate(route.begin() + (at - 1), route.begin() + first, route.begin() + stop);
+        reindex(vehicle);
+        moves += 1;
+        return true;
+      }
+    }
+
+    // After the segment: route[stop..to) moves in front of it
+    if (stop < size) {
+      auto between = visit(route[stop]);
+
+      for (auto to = stop + 1; to <= size; ++to) {
+        if (to > stop + 1)
+          between = join(between, visit(route[to - 1]));
+
+        const auto next = to == size ? depot : route[to];
+
+        if (removal + insertion(route[to - 1], next, false) >= 0)
+          continue;
+
+        if (!fits(join(join(join(heads[vehicle][first], between), segment), tails[vehicle][to]), capacity(vehicle)))
+          continue;
+
+        std::rotate(route.begin() + first, route.begin() + stop, route.begin() + to);
+        reindex(vehicle);
+        moves += 1;
+        return true;
+      }
+    }
+
+    return false;
+  }
+
+  std::int64_t peakLoad(const Route& route) const {
+    std::int64_t load = 0;
+    std::int64_t peak = 0;
+    auto previous = depot;
+
+    for (const auto node : route) {
+      load += demand(previous, node);
+      peak = std::max(peak, load);
+      previous = node;
+    }
+
+    return peak;
+  }
+
+  std::int64_t arcCost(std::int32_t from, std::int32_t to) const { return costs.at(from, to); }
+  std::int64_t duration(std::int32_t from, std::int32_t to) const { return durations.dim() == 0 ? 0 : durations.at(from, to); }
+  std::int64_t demand(std::int32_t from, std::int32_t to) const { return demands.dim() == 0 ? 0 : demands.at(from, to); }
+
+  std::int64_t windowStart(std::int32_t node) const { return timeWindows.size() == 0 ? 0 : timeWindows.at(node).start; }
+  std::int64_t windowStop(std::int32_t node) const { return timeWindows.size() == 0 ? timeHorizon : timeWindows.at(node).stop; }
+
+  std::int64_t routeEnd() const { return std::min<std::int64_t>(timeHorizon, windowStop(depot)); }
+
+  std::int64_t capacity(std::int32_t vehicle) const {
+    return vehicleCapacities.empty() ? std::numeric_limits<std::int64_t>::max() : vehicleCapacities[vehicle];
+  }
+
+  std::int64_t maxCapacity() const {
+    if (vehicleCapacities.empty())
+      return std::numeric_limits<std::int64_t>::max();
+
+    return *std::max_element(vehicleCapacities.begin(), vehicleCapacities.end());
+  }
+
+  const std::int32_t numNodes;
+  const std::int32_t numVehicles;
+  const std::int32_t depot;
+  const std::int32_t timeHorizon;
+
+  const CostMatrix& costs;
+  const DurationMatrix& durations;
+  const TimeWindows& timeWindows;
+  const DemandMatrix& demands;
+  const std::vector<int64>& vehicleCapacities;
+
+  std::vector<Route> plan;
+  std::int64_t moves = 0;
+
+  // Per vehicle while polishing, see reindex
+  std::vector<std::vector<Stretch>> heads;
+  std::vector<std::vector<Stretch>> tails;
+};
+
+#endif
@@ -0,0 +1,40 @@
+#ifndef NODE_OR_TOOLS_CPU_TIME_7B1E4D9C3A62_H
+#define NODE_OR_TOOLS_CPU_TIME_7B1E4D9C3A62_H
+
+#include <time.h>
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+#include "types.h"
+
+// CPU time the calling thread spent so far: unlike wall time it does not run while the thread waits for a core
+inline std::chrono::nanoseconds threadCpuTime() {
+  timespec now;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+
+  return std::chrono::seconds(now.tv_sec) + std::chrono::nanoseconds(now.tv_nsec);
+}
+
+// Stops the search once the thread's CPU clock reaches the deadline, e.g. threadCpuTime() plus the limit.
+// Thread CPU clocks are per thread: set up on the thread which searches.
+class CpuTimeLimit final : public ort::SearchLimit {
+public:
+  CpuTimeLimit(Solver* solver, std::chrono::nanoseconds deadline_) : ort::SearchLimit(solver), deadline{deadline_} {}
+
+  bool Check() override { return threadCpuTime() >= deadline; }
+
+  void Init() override {}
+
+  void Copy(const ort::SearchLimit* limit) override { deadline = static_cast<const CpuTimeLimit*>(limit)->deadline; }
+
+  ort::SearchLimit* MakeClone() const override { return solver()->RevAlloc(new CpuTimeLimit{solver(), deadline}); }
+
+  std::string DebugString() const override { return "CpuTimeLimit"; }
+
+private:
+  std::chrono::nanoseconds deadline; // On the thread's CPU clock
+};
+
+#endif
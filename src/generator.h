@@ -0,0 +1,204 @@
+#ifndef NODE_OR_TOOLS_GENERATOR_4E9B7C2A15D8_H
+#define NODE_OR_TOOLS_GENERATOR_4E9B7C2A15D8_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "types.h"
+
+// Where customers are, after Solomon's VRPTW benchmark classes:
+//  - Random: uniformly spread out (R)
+//  - Clustered: grouped around cluster centers, with long service times (C)
+//  - Mixed: half of them random, half of them clustered (RC)
+enum class InstanceLayout { Random, Clustered, Mixed };
+
+inline InstanceLayout makeInstanceLayoutFromName(const std::string& name) {
+  if (name == "random")
+    return InstanceLayout::Random;
+  if (name == "clustered")
+    return InstanceLayout::Clustered;
+  if (name == "mixed")
+    return InstanceLayout::Mixed;
+
+  throw std::runtime_error{"Expected layout of 'random', 'clustered' or 'mixed'"};
+}
+
+struct InstanceSpec {
+  std::int32_t numNodes = 0; // Depot plus customers
+  std::int32_t numVehicles = 0;
+  InstanceLayout layout = InstanceLayout::Random;
+  double windowTightness = 0;   // In [0, 1]: zero for no time windows, one for windows as wide as the service
+  double capacityTightness = 0; // In [0, 1]: zero for each vehicle carrying all demand, one for the fleet barely carrying it
+  std::int32_t clusters = 0;    // Zero for one cluster per ten customers
+  std::uint64_t seed = 0;
+};
+
+// Instance data in the solver's native storage; the depot is node zero
+struct GeneratedInstance {
+  CostMatrix costs;
+  DurationMatrix durations;
+  TimeWindows timeWindows;
+  DemandMatrix demands;
+
+  std::int32_t timeHorizon;
+  std::int32_t vehicleCapacity;
+};
+
+// Seeded synthetic VRPTW instances for load and scaling tests, the same ones for a seed on every platform:
+// only integer draws, IEEE arithmetic and sqrt, which IEEE 754 requires to be correctly rounded.
+// Customers sit on a 1000 x 1000 grid with the depot in its center. Costs are rounded euclidean distances,
+// durations add the service time at the location left. Time windows are centered on a random feasible visit time.
+class InstanceGenerator {
+public:
+  explicit InstanceGenerator(InstanceSpec spec_) : spec{spec_}, engine{spec_.seed} {
+    if (spec.numNodes < 1 || spec.numVehicles < 1)
+      throw std::runtime_error{"Expected at least one node and one vehicle"};
+
+    if (spec.windowTightness < 0 || spec.windowTightness > 1 || spec.capacityTightness < 0 || spec.capacityTightness > 1)
+      throw std::runtime_error{"Expected windowTightness and capacityTightness in [0, 1]"};
+
+    if (spec.clusters < 0)
+      throw std::runtime_error{"Expected non-negative clusters"};
+  }
+
+  GeneratedInstance generate() {
+    const auto n = spec.numNodes;
+
+    const auto points = makePoints();
+
+    // Solomon's service times, scaled to the grid: long stops in clusters, short ones elsewhere
+    const auto serviceTime = spec.layout == InstanceLayout::Clustered ? 900 : 100;
+    const auto timeHorizon = spec.layout == InstanceLayout::Clustered ? 34000 : 10000;
+
+    GeneratedInstance instance{CostMatrix(n), DurationMatrix(n), TimeWindows(n), DemandMatrix(n), timeHorizon, 0};
+
+    for (std::int32_t from = 0; from < n; ++from) {
+      const auto service = from == kDepot ? 0 : serviceTime;
+
+      for (std::int32_t to = 0; to < n; ++to) {
+        const auto dx = points[from].x - points[to].x;
+        const auto dy = points[from].y - points[to].y;
+        const auto distance = static_cast<std::int32_t>(std::lround(std::sqrt(dx * dx + dy * dy)));
+
+        instance.costs.at(from, to) = distance;
+        instance.durations.at(from, to) = service + distance;
+      }
+    }
+
+    instance.timeWindows.at(kDepot) = Interval{0, timeHorizon};
+
+    const auto width = std::max(static_cast<double>(serviceTime), (1 - spec.windowTightness) * timeHorizon);
+
+    for (std::int32_t node = 1; node < n; ++node) {
+      if (spec.windowTightness == 0) {
+        instance.timeWindows.at(node) = Interval{0, timeHorizon};
+        continue;
+      }
+
+      // Reachable from the depot and back in time; the center is feasible, so is the window
+      const auto earliest = instance.costs.at(kDepot, node);
+      const auto latest = timeHorizon - serviceTime - instance.costs.at(node, kDepot);
+      const auto center = earliest + uniform() * (latest - earliest);
+
+      const auto start = static_cast<std::int32_t>(std::max(0., center - width / 2));
+      const auto stop = static_cast<std::int32_t>(std::min(static_cast<double>(timeHorizon), center + width / 2));
+
+      instance.timeWindows.at(node) = Interval{start, stop};
+    }
+
+    // Demands leave with the vehicle: rows hold the demand at the location left
+    std::int64_t totalDemand = 0;
+    std::int32_t maxDemand = 0;
+
+    for (std::int32_t from = 1; from < n; ++from) {
+      const auto demand = uniformInt(1, 50);
+
+      for (std::int32_t to = 0; to < n; ++to)
+        instance.demands.at(from, to) = demand;
+
+      totalDemand += demand;
+      maxDemand = std::max(maxDemand, demand);
+    }
+
+    // Fleet capacity of totalDemand / tightness, but no vehicle needs more than all demand
+    auto perVehicle = totalDemand;
+
+    if (spec.capacityTightness > 0) {
+      const auto fleetDemand = std::ceil(totalDemand / spec.capacityTightness);
+      perVehicle = std::min(perVehicle, static_cast<std::int64_t>(std::ceil(fleetDemand / spec.numVehicles)));
+    }
+
+    instance.vehicleCapacity = static_cast<std::int32_t>(std::max<std::int64_t>(maxDemand, perVehicle));
+
+    return instance;
+  }
+
+private:
+  static constexpr std::int32_t kDepot = 0;
+  static constexpr double kGrid = 1000;
+
+  struct Point {
+    double x;
+    double y;
+  };
+
+  std::vector<Point> makePoints() {
+    std::vector<Point> points{{kGrid / 2, kGrid / 2}};
+
+    const auto customers = spec.numNodes - 1;
+    const auto clusters = spec.clusters > 0 ? spec.clusters : std::max(1, customers / 10);
+
+    std::vector<Point> centers;
+
+    for (std::int32_t cluster = 0; cluster < clusters; ++cluster)
+      centers.push_back(Point{kGrid * (0.1 + 0.8 * uniform()), kGrid * (0.1 + 0.8 * uniform())});
+
+    for (std::int32_t customer = 0; customer < customers; ++customer) {
+      const auto clustered = spec.layout == InstanceLayout::Clustered || (spec.layout == InstanceLayout::Mixed && customer % 2);
+
+      if (!clustered) {
+        points.push_back(Point{kGrid * uniform(), kGrid * uniform()});
+        continue;
+      }
+
+      const auto& center = centers[uniformInt(0, clusters - 1)];
+
+      points.push_back(Point{clamp(center.x + kGrid / 25 * normal()), clamp(center.y + kGrid / 25 * normal())});
+    }
+
+    return points;
+  }
+
+  // Own conversions of the engine's bits: std distributions differ across standard libraries
+  double uniform() { return (engine() >> 11) * (1. / 9007199254740992.); }
+
+  std::int32_t uniformInt(std::int32_t lo, std::int32_t hi) {
+    return std::min(hi, lo + static_cast<std::int32_t>(uniform() * (hi - lo + 1)));
+  }
+
+  // Irwin-Hall: twelve uniforms sum up to about a standard normal. No log or cos, their results differ across libms
+  double normal() {
+    auto sum = 0.;
+
+    for (auto draw = 0; draw < 12; ++draw)
+      sum += uniform();
+
+    return sum - 6;
+  }
+
+  // A local copy: std::min and std::max take references, which would need a definition of kGrid
+  static double clamp(double coordinate) {
+    const auto grid = kGrid;
+    return std::min(grid, std::max(0., coordinate));
+  }
+
+  const InstanceSpec spec;
+  std::mt19937_64 engine;
+};
+
+#endif
@@ -0,0 +1,51 @@
+#ifndef NODE_OR_TOOLS_ISLANDS_8D41C6B25F0A_H
+#define NODE_OR_TOOLS_ISLANDS_8D41C6B25F0A_H
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "types.h"
+
+// Cooperative search: several searches ("islands") over one instance, each on a model of its own.
+// Every sync interval islands publish their best solution and restart from the best one across islands.
+struct IslandPolicy {
+  std::int32_t islands = 0;        // Off unless at least two
+  std::int32_t syncInterval = 100; // Milliseconds
+};
+
+// Solution searches on separate models can exchange: routes translate between models of the same instance.
+struct IslandSolution {
+  std::int64_t cost;
+  std::vector<std::vector<NodeIndex>> routes;
+};
+
+// Best solution across islands. Islands publish once per sync interval; the lock is only held to compare
+// costs and swap a pointer, never while copying or searching. A plain mutex instead of std::atomic_load on
+// the shared_ptr: those are no more lock-free (the standard library locks internally) and deprecated in C++20.
+class SharedSolution {
+public:
+  std::shared_ptr<const IslandSolution> load() const {
+    std::lock_guard<std::mutex> lock{mutex};
+    return best;
+  }
+
+  // False if the slot already holds a solution at least as cheap
+  bool publish(std::shared_ptr<const IslandSolution> candidate) {
+    std::lock_guard<std::mutex> lock{mutex};
+
+    if (best && best->cost <= candidate->cost)
+      return false;
+
+    best = std::move(candidate);
+    return true;
+  }
+
+private:
+  mutable std::mutex mutex;
+  std::shared_ptr<const IslandSolution> best;
+};
+
+#endif
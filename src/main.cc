@@ -1,9 +1,13 @@
+#include "scheduler.h"
 #include "tsp.h"
 #include "vrp.h"
 
 NAN_MODULE_INIT(Init) {
   TSP::Init(target);
   VRP::Init(target);
+
+  Nan::SetMethod(target, "configureScheduler", ConfigureScheduler);
+  Nan::SetMethod(target, "schedulerStats", SchedulerStats);
 }
 
 NODE_MODULE(node_or_tools, Init)
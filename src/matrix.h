@@ -2,8 +2,12 @@
 #define NODE_OR_TOOLS_MATRIX_F83F49233E85_H
 
 #include <cstdint>
+#include <memory>
+#include <stdexcept>
 #include <vector>
 
+#include "compressed_tiles.h"
+
 template <typename T> class Matrix {
   static_assert(std::is_arithmetic<T>::value, "Matrix<T> requires T to be integral or floating point");
 
@@ -21,12 +25,33 @@ public:
   std::int32_t dim() const { return n; }
   std::int32_t size() const { return dim() * dim(); }
 
-  T& at(std::int32_t x, std::int32_t y) { return data.at(y * n + x); }
-  const T& at(std::int32_t x, std::int32_t y) const { return data.at(y * n + x); }
+  // Bytes actually held: raw array or compressed tiles
+  std::int32_t bytes() const { return tiles ? tiles->bytes() : size() * sizeof(T); }
+
+  T& at(std::int32_t x, std::int32_t y) {
+    if (tiles)
+      throw std::runtime_error{"Compressed matrix is read-only"};
+
+    return data.at(y * n + x);
+  }
+
+  T at(std::int32_t x, std::int32_t y) const { return tiles ? tiles->at(x, y) : data.at(y * n + x); }
+
+  // Swaps the raw array for compressed tiles, see compressed_tiles.h. Read-only afterwards.
+  void compress() {
+    if (tiles)
+      return;
+
+    tiles = std::make_shared<const CompressedTiles<T>>(n, data);
+    std::vector<T>{}.swap(data);
+  }
+
+  bool compressed() const { return tiles != nullptr; }
 
 private:
-  std::int32_t n;
+  std::int32_t n = 0;
   std::vector<T> data;
+  std::shared_ptr<const CompressedTiles<T>> tiles;
 };
 
 #endif
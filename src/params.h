@@ -43,4 +43,17 @@ template <typename Matrix> inline auto makeMatrixFrom2dArray(std::int32_t n, v8:
   return matrix;
 }
 
+// Optional 'compressMatrices' (Boolean): trades lookup speed for memory on instances kept around for a long time
+inline bool makeCompressMatricesFromOptions(v8::Local<v8::Object> opts) {
+  auto maybeCompressMatrices = Nan::Get(opts, Nan::New("compressMatrices").ToLocalChecked());
+
+  if (maybeCompressMatrices.IsEmpty() || maybeCompressMatrices.ToLocalChecked()->IsUndefined())
+    return false;
+
+  if (!maybeCompressMatrices.ToLocalChecked()->IsBoolean())
+    throw std::runtime_error{"SolverOptions expects 'compressMatrices' (Boolean)"};
+
+  return Nan::To<bool>(maybeCompressMatrices.ToLocalChecked()).FromJust();
+}
+
 #endif
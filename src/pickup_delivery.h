@@ -0,0 +1,194 @@
+#ifndef NODE_OR_TOOLS_PICKUP_DELIVERY_7E2A90C4D1B8_H
+#define NODE_OR_TOOLS_PICKUP_DELIVERY_7E2A90C4D1B8_H
+
+#include "ortools/constraint_solver/constraint_solveri.h"
+#include "ortools/constraint_solver/routing.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "types.h"
+
+// How pickup and delivery pairs get enforced:
+//  - Constraints: per pair an equality on vehicles and a precedence on time cumuls; needs the time dimension
+//  - Paths: a single constraint walking the routes; also supports loading orders
+enum class PickupDeliveryMode { Constraints, Paths };
+
+// Which load a delivery may unload in Paths mode:
+//  - Any: every load on board
+//  - Lifo: the last load picked up, e.g. for rear-loaded vehicles
+//  - Fifo: the first load picked up
+enum class PickupDeliveryOrder { Any, Lifo, Fifo };
+
+struct PickupDeliveryPolicy {
+  PickupDeliveryMode mode = PickupDeliveryMode::Constraints;
+  PickupDeliveryOrder order = PickupDeliveryOrder::Any;
+};
+
+inline PickupDeliveryMode makePickupDeliveryModeFromName(const std::string& name) {
+  if (name == "constraints")
+    return PickupDeliveryMode::Constraints;
+  if (name == "paths")
+    return PickupDeliveryMode::Paths;
+
+  throw std::runtime_error{"Expected pickupDeliveryMode of 'constraints' or 'paths'"};
+}
+
+inline PickupDeliveryOrder makePickupDeliveryOrderFromName(const std::string& name) {
+  if (name == "any")
+    return PickupDeliveryOrder::Any;
+  if (name == "lifo")
+    return PickupDeliveryOrder::Lifo;
+  if (name == "fifo")
+    return PickupDeliveryOrder::Fifo;
+
+  throw std::runtime_error{"Expected pickupDeliveryOrder of 'any', 'lifo' or 'fifo'"};
+}
+
+// All pickup and delivery pairs in one constraint: walks the bound prefix of routes that grew and fails as soon as
+// a delivery comes without its load on board, in the wrong order, or a route ends with loads still on board.
+// Pickups on a route pin their delivery's vehicle, so same-route follows without per pair constraints.
+class PickupDeliveryConstraint final : public ort::Constraint {
+public:
+  PickupDeliveryConstraint(Solver* solver, const RoutingModel& model_, const Pickups& pickups, const Deliveries& deliveries,
+                           PickupDeliveryOrder order_)
+      : ort::Constraint(solver), model(model_), order{order_}, pairOf(model.Size(), -1), deliveryOf(pickups.size()),
+        walked(model.vehicles(), 0) {
+
+    for (std::int32_t atIdx = 0; atIdx < pickups.size(); ++atIdx) {
+      const auto pickupIndex = model.NodeToIndex(pickups.at(atIdx));
+      const auto deliveryIndex = model.NodeToIndex(deliveries.at(atIdx));
+
+      pairOf[pickupIndex] = atIdx;
+      pairOf[deliveryIndex] = atIdx;
+      deliveryOf[atIdx] = deliveryIndex;
+    }
+  }
+
+  void Post() override {
+    propagateDemon = ort::MakeDelayedConstraintDemon0(solver(), this, &PickupDeliveryConstraint::Propagate, "Propagate");
+
+    for (std::int32_t index = 0; index < model.Size(); ++index) {
+      auto* demon = ort::MakeConstraintDemon1(solver(), this, &PickupDeliveryConstraint::NextBound, "NextBound", int64{index});
+      model.NextVar(index)->WhenBound(demon);
+    }
+  }
+
+  void InitialPropagate() override {
+    for (std::int32_t vehicle = 0; vehicle < model.vehicles(); ++vehicle)
+      propagateRoute(vehicle);
+  }
+
+  // Remembers where routes grew; the delayed Propagate then walks only the routes these indices are on
+  void NextBound(int64 index) {
+    touched.push_back(index);
+    EnqueueDelayedDemon(propagateDemon);
+  }
+
+  void Propagate() {
+    ++walk;
+
+    for (const auto index : touched) {
+      // Unknown vehicle: index is not yet on a route's bound prefix, binding the prefix up to it wakes us again
+      const auto* vehicleVar = model.VehicleVar(index);
+
+      if (!vehicleVar->Bound() || vehicleVar->Value() < 0)
+        continue;
+
+      const auto vehicle = vehicleVar->Value();
+
+      if (walked[vehicle] == walk)
+        continue;
+
+      walked[vehicle] = walk;
+      propagateRoute(vehicle);
+    }
+
+    touched.clear();
+  }
+
+  std::string DebugString() const override { return "PickupDeliveryConstraint"; }
+
+private:
+  void propagateRoute(std::int32_t vehicle) {
+    onBoard.clear();
+
+    auto index = model.Start(vehicle);
+
+    while (model.NextVar(index)->Bound()) {
+      index = model.NextVar(index)->Value();
+
+      if (model.IsEnd(index)) {
+        if (!onBoard.empty())
+          solver()->Fail();
+
+        return;
+      }
+
+      const auto pair = pairOf[index];
+
+      if (pair < 0)
+        continue;
+
+      if (index != deliveryOf[pair]) {
+        onBoard.push_back(pair);
+        model.VehicleVar(deliveryOf[pair])->SetValue(vehicle);
+        continue;
+      }
+
+      unload(pair);
+    }
+  }
+
+  void unload(std::int32_t pair) {
+    switch (order) {
+    case PickupDeliveryOrder::Lifo:
+      if (onBoard.empty() || onBoard.back() != pair)
+        solver()->Fail();
+
+      onBoard.pop_back();
+      break;
+
+    case PickupDeliveryOrder::Fifo:
+      if (onBoard.empty() || onBoard.front() != pair)
+        solver()->Fail();
+
+      onBoard.pop_front();
+      break;
+
+    case PickupDeliveryOrder::Any: {
+      const auto it = std::find(onBoard.begin(), onBoard.end(), pair);
+
+      if (it == onBoard.end())
+        solver()->Fail();
+
+      onBoard.erase(it);
+      break;
+    }
+    }
+  }
+
+  const RoutingModel& model;
+  const PickupDeliveryOrder order;
+
+  // Pair per index or -1, delivery index per pair
+  std::vector<std::int32_t> pairOf;
+  std::vector<std::int64_t> deliveryOf;
+
+  // Scratch space for walking routes
+  std::deque<std::int32_t> onBoard;
+
+  // Indices whose next got bound since the last Propagate; left over after a failure, walking them again is harmless
+  std::vector<int64> touched;
+  ort::Demon* propagateDemon = nullptr;
+
+  // Per vehicle the last walk it was propagated in, for walking every route at most once per Propagate
+  std::vector<std::int64_t> walked;
+  std::int64_t walk = 0;
+};
+
+#endif
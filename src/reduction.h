@@ -0,0 +1,279 @@
+#ifndef NODE_OR_TOOLS_REDUCTION_9C3B7D2E41F5_H
+#define NODE_OR_TOOLS_REDUCTION_9C3B7D2E41F5_H
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "types.h"
+
+// Contracts locked route chains into their first node ("head"), so the solver sees a single node per chain.
+//  - Arcs leaving a head carry the chain's inner values plus the arc leaving its last node
+//  - Arcs entering a head are the arcs entering its first node
+//  - Heads get the time window of serving the chain without waiting
+// Chains which can not be served without waiting or contain pinned nodes are left as they are.
+// Nothing is contracted for invalid locks, so the solver rejects them as it does without contraction.
+// Reduced nodes are numbered in original order; solutions are expanded back via expandRoute and offset.
+class ChainContraction {
+public:
+  ChainContraction(std::int32_t numNodes, std::int32_t depot, const RouteLocks& locks, const std::vector<bool>& pinned,
+                   const CostMatrix& costs, const DurationMatrix& durations, const TimeWindows& timeWindows)
+      : chainOf(numNodes, -1), offsets(numNodes, 0), innerCosts(numNodes, 0) {
+
+    std::vector<bool> inner(numNodes, false);
+
+    const auto contractible = validLocks(numNodes, depot, locks);
+
+    for (const auto& lock : locks) {
+      if (!contractible || lock.size() < 2)
+        continue;
+
+      std::vector<std::int32_t> chain;
+
+      for (const auto& node : lock)
+        chain.push_back(node.value());
+
+      if (std::any_of(chain.begin(), chain.end(), [&](std::int32_t node) { return pinned[node]; }))
+        continue;
+
+      if (!assignOffsets(chain, durations, timeWindows))
+        continue;
+
+      for (std::size_t atIdx = 1; atIdx < chain.size(); ++atIdx) {
+        inner[chain[atIdx]] = true;
+        innerCosts[chain[atIdx]] = costs.at(chain[atIdx - 1], chain[atIdx]);
+      }
+
+      chainOf[chain.front()] = chains.size();
+      chains.push_back(std::move(chain));
+    }
+
+    for (std::int32_t node = 0; node < numNodes; ++node) {
+      if (inner[node]) {
+        toReduced.push_back(-1);
+      } else {
+        toReduced.push_back(toOriginal.size());
+        toOriginal.push_back(node);
+      }
+    }
+  }
+
+  // Nothing to contract: solve on the original nodes
+  bool empty() const { return chains.empty(); }
+
+  std::int32_t size() const { return toOriginal.size(); }
+
+  std::int32_t reduce(std::int32_t node) const { return toReduced[node]; }
+
+  // Duration from the chain's head to node, zero for nodes not in chains
+  std::int64_t offset(std::int32_t node) const { return offsets[node]; }
+
+  template <typename Matrix> Matrix reduceMatrix(const Matrix& matrix) const {
+    if (matrix.dim() == 0)
+      return Matrix{};
+
+    Matrix reduced(size());
+
+    for (std::int32_t from = 0; from < size(); ++from) {
+      const auto fromChain = expand(from);
+      const auto inside = sumAlong(matrix, fromChain);
+
+      for (std::int32_t to = 0; to < size(); ++to)
+        reduced.at(from, to) = inside + matrix.at(fromChain.back(), toOriginal[to]);
+    }
+
+    return reduced;
+  }
+
+  template <typename Vector> Vector reduceVector(const Vector& vector) const {
+    Vector reduced(size());
+
+    for (std::int32_t node = 0; node < size(); ++node) {
+      typename Vector::Value sum = 0;
+
+      for (const auto original : expand(node))
+        sum += vector.at(original);
+
+      reduced.at(node) = sum;
+    }
+
+    return reduced;
+  }
+
+  Resources reduceResources(const Resources& resources) const {
+    Resources reduced;
+
+    for (const auto& resource : resources) {
+      if (resource.perArc)
+        reduced.emplace_back(resource.name, reduceMatrix(resource.arcs));
+      else
+        reduced.emplace_back(resource.name, reduceVector(resource.nodes));
+    }
+
+    return reduced;
+  }
+
+  TimeWindows reduceTimeWindows(const TimeWindows& timeWindows) const {
+    if (timeWindows.size() == 0)
+      return TimeWindows{};
+
+    TimeWindows reduced(size());
+
+    for (std::int32_t node = 0; node < size(); ++node) {
+      std::int64_t start = 0;
+      std::int64_t stop = std::numeric_limits<std::int32_t>::max();
+
+      for (const auto original : expand(node)) {
+        start = std::max<std::int64_t>(start, timeWindows.at(original).start - offsets[original]);
+        stop = std::min<std::int64_t>(stop, timeWindows.at(original).stop - offsets[original]);
+      }
+
+      reduced.at(node) = Interval{static_cast<std::int32_t>(start), static_cast<std::int32_t>(stop)};
+    }
+
+    return reduced;
+  }
+
+  template <typename NodeVector> NodeVector reduceNodes(const NodeVector& nodes) const {
+    NodeVector reduced(nodes.size());
+
+    for (std::int32_t atIdx = 0; atIdx < nodes.size(); ++atIdx)
+      reduced.at(atIdx) = NodeIndex{reduce(nodes.at(atIdx).value())};
+
+    return reduced;
+  }
+
+  RouteLocks reduceLocks(const RouteLocks& locks) const {
+    RouteLocks reduced(locks.size());
+
+    for (std::size_t vehicle = 0; vehicle < locks.size(); ++vehicle)
+      for (const auto& node : locks.at(vehicle))
+        if (reduce(node.value()) != -1)
+          reduced.at(vehicle).push_back(NodeIndex{reduce(node.value())});
+
+    return reduced;
+  }
+
+  // Penalized nodes are expected to be pinned, so every soft window stays with its node
+  SoftTimeWindows reduceSoftTimeWindows(const SoftTimeWindows& softTimeWindows) const {
+    if (softTimeWindows.size() == 0)
+      return SoftTimeWindows{};
+
+    SoftTimeWindows reduced(size());
+
+    for (std::int32_t node = 0; node < size(); ++node)
+      reduced.at(node) = softTimeWindows.at(toOriginal[node]);
+
+    return reduced;
+  }
+
+  // Restricted nodes are expected to be pinned, so every restriction stays with its node
+  AllowedVehicles reduceAllowedVehicles(const AllowedVehicles& allowed) const {
+    if (allowed.size() == 0)
+      return AllowedVehicles{};
+
+    AllowedVehicles reduced;
+
+    for (std::int32_t node = 0; node < size(); ++node)
+      reduced.append(allowed.at(toOriginal[node]));
+
+    return reduced;
+  }
+
+  // Original nodes a reduced node stands for, in visiting order
+  std::vector<std::int32_t> expand(std::int32_t node) const {
+    const auto original = toOriginal[node];
+
+    if (chainOf[original] == -1)
+      return {original};
+
+    return chains[chainOf[original]];
+  }
+
+  std::vector<NodeIndex> expandRoute(const std::vector<NodeIndex>& route) const {
+    std::vector<NodeIndex> expanded;
+
+    for (const auto& node : route)
+      for (const auto original : expand(node.value()))
+        expanded.push_back(NodeIndex{original});
+
+    return expanded;
+  }
+
+  // Splits the cost of leaving a head into its chain's inner arcs and the arc leaving its last node
+  std::vector<std::int64_t> expandArcCost(std::int32_t from, std::int64_t cost) const {
+    const auto chain = expand(from);
+
+    std::vector<std::int64_t> expanded;
+
+    for (std::size_t atIdx = 1; atIdx < chain.size(); ++atIdx) {
+      expanded.push_back(innerCosts[chain[atIdx]]);
+      cost -= expanded.back();
+    }
+
+    expanded.push_back(cost);
+
+    return expanded;
+  }
+
+private:
+  // Lock nodes have to be in range, not the depot and locked only once across all vehicles
+  static bool validLocks(std::int32_t numNodes, std::int32_t depot, const RouteLocks& locks) {
+    std::vector<bool> locked(numNodes, false);
+
+    for (const auto& lock : locks) {
+      for (const auto& node : lock) {
+        if (node.value() < 0 || node.value() >= numNodes || node.value() == depot || locked[node.value()])
+          return false;
+
+        locked[node.value()] = true;
+      }
+    }
+
+    return true;
+  }
+
+  // Offsets along the chain; false if there is no start time serving all of it without waiting
+  bool assignOffsets(const std::vector<std::int32_t>& chain, const DurationMatrix& durations, const TimeWindows& timeWindows) {
+    std::vector<std::int64_t> chainOffsets(chain.size(), 0);
+
+    for (std::size_t atIdx = 1; atIdx < chain.size() && durations.dim() != 0; ++atIdx)
+      chainOffsets[atIdx] = chainOffsets[atIdx - 1] + durations.at(chain[atIdx - 1], chain[atIdx]);
+
+    std::int64_t start = 0;
+    std::int64_t stop = std::numeric_limits<std::int32_t>::max();
+
+    for (std::size_t atIdx = 0; atIdx < chain.size() && timeWindows.size() != 0; ++atIdx) {
+      start = std::max<std::int64_t>(start, timeWindows.at(chain[atIdx]).start - chainOffsets[atIdx]);
+      stop = std::min<std::int64_t>(stop, timeWindows.at(chain[atIdx]).stop - chainOffsets[atIdx]);
+    }
+
+    if (start > stop)
+      return false;
+
+    for (std::size_t atIdx = 0; atIdx < chain.size(); ++atIdx)
+      offsets[chain[atIdx]] = chainOffsets[atIdx];
+
+    return true;
+  }
+
+  template <typename Matrix> std::int64_t sumAlong(const Matrix& matrix, const std::vector<std::int32_t>& chain) const {
+    std::int64_t sum = 0;
+
+    for (std::size_t atIdx = 1; atIdx < chain.size(); ++atIdx)
+      sum += matrix.at(chain[atIdx - 1], chain[atIdx]);
+
+    return sum;
+  }
+
+  std::vector<std::vector<std::int32_t>> chains;
+  std::vector<std::int32_t> chainOf; // Chain per head or -1
+  std::vector<std::int64_t> offsets;
+  std::vector<std::int64_t> innerCosts; // Cost of the arc entering inner nodes
+
+  std::vector<std::int32_t> toReduced; // Reduced node per node or -1 for inner nodes
+  std::vector<std::int32_t> toOriginal;
+};
+
+#endif
@@ -0,0 +1,269 @@
+#include "scheduler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+
+// Never destroyed: idle threads wait on its condition variable until the process exits
+SchedulerThreads& SchedulerThreads::get() {
+  static auto* threads = new SchedulerThreads;
+  return *threads;
+}
+
+SchedulerThreads::SchedulerThreads() {
+  async.data = this;
+  uv_async_init(uv_default_loop(), &async, [](uv_async_t* handle) { static_cast<SchedulerThreads*>(handle->data)->complete(); });
+
+  // Only workers not completed yet keep the event loop alive, see queue
+  uv_unref(reinterpret_cast<uv_handle_t*>(&async));
+}
+
+void SchedulerThreads::queue(Nan::AsyncWorker* worker) {
+  if (outstanding++ == 0)
+    uv_ref(reinterpret_cast<uv_handle_t*>(&async));
+
+  std::lock_guard<std::mutex> lock{mutex};
+
+  pending.push_back(worker);
+
+  // Every pending worker has a thread of its own: queued behind a parked solve it would not even be waiting for a core
+  if (idle > 0) {
+    idle -= 1;
+    wakeups += 1;
+    queued.notify_one();
+  } else {
+    std::thread{&SchedulerThreads::run, this}.detach();
+  }
+}
+
+void SchedulerThreads::run() {
+  std::unique_lock<std::mutex> lock{mutex};
+
+  for (;;) {
+    auto* worker = pending.front();
+    pending.pop_front();
+
+    lock.unlock();
+    worker->Execute();
+    lock.lock();
+
+    finished.push_back(worker);
+    uv_async_send(&async);
+
+    idle += 1;
+    queued.wait(lock, [&] { return wakeups > 0; });
+    wakeups -= 1;
+  }
+}
+
+// On the event loop thread; sends coalesce, so completes all workers finished so far
+void SchedulerThreads::complete() {
+  std::deque<Nan::AsyncWorker*> done;
+
+  {
+    std::lock_guard<std::mutex> lock{mutex};
+    done.swap(finished);
+  }
+
+  for (auto* worker : done) {
+    worker->WorkComplete();
+    worker->Destroy();
+
+    if (--outstanding == 0)
+      uv_unref(reinterpret_cast<uv_handle_t*>(&async));
+  }
+}
+
+struct SchedulerParams {
+  SchedulerParams(const Nan::FunctionCallbackInfo<v8::Value>& info);
+
+  std::int32_t cores;
+  std::int32_t timeSlice;
+  std::int32_t quotaPeriod;
+  double budgetFloor;
+  std::map<std::string, Scheduler::TenantPolicy> tenants;
+};
+
+// Caches user provided {weight, maxRunning, cpuQuota} into a tenant's policy
+inline auto makeTenantPolicyFromObject(v8::Local<v8::Object> opts) {
+  Scheduler::TenantPolicy policy;
+
+  auto maybeWeight = Nan::Get(opts, Nan::New("weight").ToLocalChecked());
+
+  if (!maybeWeight.IsEmpty() && !maybeWeight.ToLocalChecked()->IsUndefined()) {
+    if (!maybeWeight.ToLocalChecked()->IsNumber())
+      throw std::runtime_error{"TenantOptions expects 'weight' (Number)"};
+
+    policy.weight = Nan::To<double>(maybeWeight.ToLocalChecked()).FromJust();
+
+    if (!(policy.weight > 0))
+      throw std::runtime_error{"Expected 'weight' to be positive"};
+  }
+
+  auto maybeMaxRunning = Nan::Get(opts, Nan::New("maxRunning").ToLocalChecked());
+
+  if (!maybeMaxRunning.IsEmpty() && !maybeMaxRunning.ToLocalChecked()->IsUndefined()) {
+    if (!maybeMaxRunning.ToLocalChecked()->IsNumber())
+      throw std::runtime_error{"TenantOptions expects 'maxRunning' (Number)"};
+
+    policy.maxRunning = Nan::To<std::int32_t>(maybeMaxRunning.ToLocalChecked()).FromJust();
+
+    if (policy.maxRunning < 0)
+      throw std::runtime_error{"Expected 'maxRunning' to be zero or positive"};
+  }
+
+  // Seconds of run time per quota period
+  auto maybeCpuQuota = Nan::Get(opts, Nan::New("cpuQuota").ToLocalChecked());
+
+  if (!maybeCpuQuota.IsEmpty() && !maybeCpuQuota.ToLocalChecked()->IsUndefined()) {
+    if (!maybeCpuQuota.ToLocalChecked()->IsNumber())
+      throw std::runtime_error{"TenantOptions expects 'cpuQuota' (Number)"};
+
+    const auto seconds = Nan::To<double>(maybeCpuQuota.ToLocalChecked()).FromJust();
+
+    if (seconds < 0)
+      throw std::runtime_error{"Expected 'cpuQuota' to be zero or positive"};
+
+    policy.cpuQuota = std::chrono::milliseconds(static_cast<std::int64_t>(seconds * 1000));
+  }
+
+  return policy;
+}
+
+SchedulerParams::SchedulerParams(const Nan::FunctionCallbackInfo<v8::Value>& info) {
+  if (info.Length() != 1 || !info[0]->IsObject())
+    throw std::runtime_error{"Single object argument expected: SchedulerOptions"};
+
+  auto opts = info[0].As<v8::Object>();
+
+  // Optional: defaults to all cores the machine has
+  auto maybeCores = Nan::Get(opts, Nan::New("cores").ToLocalChecked());
+
+  cores = std::max<std::int32_t>(std::thread::hardware_concurrency(), 1);
+
+  if (!maybeCores.IsEmpty() && !maybeCores.ToLocalChecked()->IsUndefined()) {
+    if (!maybeCores.ToLocalChecked()->IsNumber())
+      throw std::runtime_error{"SchedulerOptions expects 'cores' (Number)"};
+
+    cores = Nan::To<std::int32_t>(maybeCores.ToLocalChecked()).FromJust();
+
+    if (cores < 0)
+      throw std::runtime_error{"Expected 'cores' to be zero or positive"};
+  }
+
+  // Optional: milliseconds a solve searches before it may have to give up its core
+  auto maybeTimeSlice = Nan::Get(opts, Nan::New("timeSlice").ToLocalChecked());
+
+  timeSlice = 5;
+
+  if (!maybeTimeSlice.IsEmpty() && !maybeTimeSlice.ToLocalChecked()->IsUndefined()) {
+    if (!maybeTimeSlice.ToLocalChecked()->IsNumber())
+      throw std::runtime_error{"SchedulerOptions expects 'timeSlice' (Number)"};
+
+    timeSlice = Nan::To<std::int32_t>(maybeTimeSlice.ToLocalChecked()).FromJust();
+
+    if (timeSlice < 1)
+      throw std::runtime_error{"Expected 'timeSlice' to be positive"};
+  }
+
+  // Optional: milliseconds after which tenants' quotas start over
+  auto maybeQuotaPeriod = Nan::Get(opts, Nan::New("quotaPeriod").ToLocalChecked());
+
+  quotaPeriod = 60 * 1000;
+
+  if (!maybeQuotaPeriod.IsEmpty() && !maybeQuotaPeriod.ToLocalChecked()->IsUndefined()) {
+    if (!maybeQuotaPeriod.ToLocalChecked()->IsNumber())
+      throw std::runtime_error{"SchedulerOptions expects 'quotaPeriod' (Number)"};
+
+    quotaPeriod = Nan::To<std::int32_t>(maybeQuotaPeriod.ToLocalChecked()).FromJust();
+
+    if (quotaPeriod < 1)
+      throw std::runtime_error{"Expected 'quotaPeriod' to be positive"};
+  }
+
+  // Optional: fraction of the time limit solves keep when shrinking budgets under overload; one for never shrinking
+  auto maybeBudgetFloor = Nan::Get(opts, Nan::New("budgetFloor").ToLocalChecked());
+
+  budgetFloor = 1;
+
+  if (!maybeBudgetFloor.IsEmpty() && !maybeBudgetFloor.ToLocalChecked()->IsUndefined()) {
+    if (!maybeBudgetFloor.ToLocalChecked()->IsNumber())
+      throw std::runtime_error{"SchedulerOptions expects 'budgetFloor' (Number)"};
+
+    budgetFloor = Nan::To<double>(maybeBudgetFloor.ToLocalChecked()).FromJust();
+
+    if (!(budgetFloor > 0 && budgetFloor <= 1))
+      throw std::runtime_error{"Expected 'budgetFloor' in (0, 1]"};
+  }
+
+  // Optional: policies keyed by tenant name, see Solve's 'tenant'
+  auto maybeTenants = Nan::Get(opts, Nan::New("tenants").ToLocalChecked());
+
+  if (!maybeTenants.IsEmpty() && !maybeTenants.ToLocalChecked()->IsUndefined()) {
+    if (!maybeTenants.ToLocalChecked()->IsObject())
+      throw std::runtime_error{"SchedulerOptions expects 'tenants' (Object)"};
+
+    auto tenantsObject = maybeTenants.ToLocalChecked().As<v8::Object>();
+    auto names = Nan::GetOwnPropertyNames(tenantsObject).ToLocalChecked();
+
+    for (std::uint32_t atIdx = 0; atIdx < names->Length(); ++atIdx) {
+      auto name = Nan::Get(names, atIdx).ToLocalChecked();
+      auto tenant = Nan::Get(tenantsObject, name).ToLocalChecked();
+
+      if (!tenant->IsObject())
+        throw std::runtime_error{"Expected 'tenants' to be an Object of Objects"};
+
+      tenants.emplace(*Nan::Utf8String{name}, makeTenantPolicyFromObject(tenant.As<v8::Object>()));
+    }
+  }
+}
+
+NAN_METHOD(ConfigureScheduler) try {
+  SchedulerParams userParams{info};
+
+  Scheduler::Policy policy;
+
+  policy.cores = userParams.cores;
+  policy.timeSlice = std::chrono::milliseconds(userParams.timeSlice);
+  policy.quotaPeriod = std::chrono::milliseconds(userParams.quotaPeriod);
+  policy.tenants = std::move(userParams.tenants);
+  policy.budgetFloor = userParams.budgetFloor;
+
+  Scheduler::get().configure(std::move(policy));
+
+} catch (const std::exception& e) {
+  return Nan::ThrowError(e.what());
+}
+
+NAN_METHOD(SchedulerStats) {
+  auto jsStats = Nan::New<v8::Object>();
+
+  for (const auto& tenant : Scheduler::get().stats()) {
+    auto jsTenant = Nan::New<v8::Object>();
+
+    Nan::Set(jsTenant, Nan::New("running").ToLocalChecked(), Nan::New<v8::Number>(tenant.running));
+    Nan::Set(jsTenant, Nan::New("waiting").ToLocalChecked(), Nan::New<v8::Number>(tenant.waiting));
+    Nan::Set(jsTenant, Nan::New("completed").ToLocalChecked(), Nan::New<v8::Number>(tenant.completed));
+    Nan::Set(jsTenant, Nan::New("runTime").ToLocalChecked(), Nan::New<v8::Number>(tenant.runTime));
+    Nan::Set(jsTenant, Nan::New("quotaUsed").ToLocalChecked(), Nan::New<v8::Number>(tenant.quotaUsed));
+
+    auto jsLatency = Nan::New<v8::Object>();
+
+    Nan::Set(jsLatency, Nan::New("p50").ToLocalChecked(), Nan::New<v8::Number>(tenant.latencyP50));
+    Nan::Set(jsLatency, Nan::New("p90").ToLocalChecked(), Nan::New<v8::Number>(tenant.latencyP90));
+    Nan::Set(jsLatency, Nan::New("p99").ToLocalChecked(), Nan::New<v8::Number>(tenant.latencyP99));
+
+    Nan::Set(jsTenant, Nan::New("latency").ToLocalChecked(), jsLatency);
+
+    Nan::Set(jsStats, Nan::New(tenant.name).ToLocalChecked(), jsTenant);
+  }
+
+  info.GetReturnValue().Set(jsStats);
+}
@@ -0,0 +1,442 @@
+#ifndef NODE_OR_TOOLS_SCHEDULER_6E2A9F4C17B3_H
+#define NODE_OR_TOOLS_SCHEDULER_6E2A9F4C17B3_H
+
+#include <nan.h>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "types.h"
+
+// Interleaves solves on a fixed number of cores, weighted-fair across tenants and earliest deadline first within them.
+// Solves keep their thread but only search while holding a core: every time slice the running search
+// checks in and parks if a waiting solve is up next, resuming where it left off once it is up again.
+// Scheduled solves run on threads of the scheduler's own, see SchedulerThreads.
+//  - Tenants get cores in proportion to their weight: the tenant with the least run time over weight goes first
+//  - Tenants may be capped to a number of cores and to a quota of run time per quota period
+//  - Under overload, budgets shrink with the queue depth per core and the time left to the deadline, down to a floor
+// Off until configured with at least one core, see configureScheduler in API.md.
+class Scheduler {
+public:
+  using Clock = std::chrono::steady_clock;
+
+  struct TenantPolicy {
+    double weight = 1;
+    std::int32_t maxRunning = 0;           // Cores at most, zero for no cap
+    std::chrono::milliseconds cpuQuota{0}; // Run time per quota period, zero for no quota
+  };
+
+  struct Policy {
+    std::int32_t cores = 0;
+    std::chrono::milliseconds timeSlice{5};
+    std::chrono::milliseconds quotaPeriod{60 * 1000};
+    std::map<std::string, TenantPolicy> tenants; // Tenants left out get the default policy
+    double budgetFloor = 1;                      // Fraction of the budget kept under overload, one for no shrinking
+  };
+
+  // Queue and latency metrics per tenant, times in milliseconds
+  struct TenantStats {
+    std::string name;
+    std::int32_t running;
+    std::int32_t waiting;
+    std::int64_t completed;
+    std::int64_t runTime;   // In total
+    std::int64_t quotaUsed; // In the current quota period
+    std::int64_t latencyP50;
+    std::int64_t latencyP90;
+    std::int64_t latencyP99;
+  };
+
+  class Task {
+  public:
+    // Due once the budget's time passed after submission
+    Task(Clock::time_point submitted, Clock::duration budget_, std::string tenantName_ = "")
+        : deadline{submitted + budget_}, tenantName{std::move(tenantName_)}, requested{budget_}, granted{budget_} {}
+
+    // Time spent holding a core; only meaningful to the task's own thread while it holds one
+    Clock::duration runTime() const { return ran + (Clock::now() - sliceStart); }
+
+    // Run time the task may search for; shrinks under overload, see Policy::budgetFloor
+    Clock::duration budget() const { return granted; }
+
+    // Time spent waiting for a core
+    Clock::duration waitTime() const { return waited; }
+
+  private:
+    friend class Scheduler;
+
+    const Clock::time_point deadline;
+    const std::string tenantName;
+    const Clock::duration requested;
+    Clock::duration granted;
+    std::uint64_t sequence = 0; // Submission order, breaks deadline ties
+
+    Clock::time_point sliceStart;
+    Clock::duration slice{0};
+    Clock::duration ran{0};
+    Clock::duration waited{0};
+  };
+
+  // Holds a core for the task's lifetime
+  class Slot {
+  public:
+    explicit Slot(Task& task_) : task(task_) { get().enter(task); }
+    ~Slot() { get().leave(task); }
+
+    Slot(const Slot&) = delete;
+    Slot& operator=(const Slot&) = delete;
+
+  private:
+    Task& task;
+  };
+
+  static Scheduler& get() {
+    static Scheduler scheduler;
+    return scheduler;
+  }
+
+  // Zero cores turns scheduling off, letting parked tasks run to completion. Tenants keep their metrics.
+  void configure(Policy policy_) {
+    std::lock_guard<std::mutex> lock{mutex};
+
+    policy = std::move(policy_);
+
+    for (auto& tenant : tenants)
+      tenant.second.policy = policyFor(tenant.first);
+
+    changed.notify_all();
+  }
+
+  bool enabled() const {
+    std::lock_guard<std::mutex> lock{mutex};
+    return policy.cores > 0;
+  }
+
+  // Blocks until the task holds a core
+  void enter(Task& task) {
+    std::unique_lock<std::mutex> lock{mutex};
+
+    auto& tenant = tenantOf(task);
+
+    // Idle tenants catch up instead of claiming the run time they did not use
+    if (tenant.running + tenant.waiting == 0)
+      tenant.virtualTime = std::max(tenant.virtualTime, minVirtualTime());
+
+    task.sequence = submitted++;
+    wait(task, lock);
+
+    tenant.latencies.push_back(task.waited);
+
+    if (tenant.latencies.size() > kLatencySamples)
+      tenant.latencies.pop_front();
+  }
+
+  void leave(Task& task) {
+    std::lock_guard<std::mutex> lock{mutex};
+
+    charge(task, Clock::now());
+    release(task);
+
+    tenantOf(task).completed += 1;
+
+    changed.notify_all();
+  }
+
+  // Called by the running task; once its slice is over the core goes to whichever task is up next
+  void yield(Task& task) {
+    const auto now = Clock::now();
+
+    if (now - task.sliceStart < task.slice)
+      return;
+
+    std::unique_lock<std::mutex> lock{mutex};
+
+    charge(task, now);
+    release(task);
+
+    changed.notify_all();
+
+    wait(task, lock);
+  }
+
+  std::vector<TenantStats> stats() const {
+    std::lock_guard<std::mutex> lock{mutex};
+
+    std::vector<TenantStats> out;
+
+    for (const auto& it : tenants) {
+      const auto& tenant = it.second;
+
+      std::vector<Clock::duration> latencies(tenant.latencies.begin(), tenant.latencies.end());
+      std::sort(latencies.begin(), latencies.end());
+
+      const auto percentile = [&](std::size_t p) -> std::int64_t {
+        if (latencies.empty())
+          return 0;
+
+        return toMilliseconds(latencies[(latencies.size() - 1) * p / 100]);
+      };
+
+      out.push_back(TenantStats{it.first, tenant.running, tenant.waiting, tenant.completed, toMilliseconds(tenant.runTime),
+                                toMilliseconds(tenant.quotaUsed), percentile(50), percentile(90), percentile(99)});
+    }
+
+    return out;
+  }
+
+private:
+  static constexpr std::size_t kLatencySamples = 1000;
+
+  // Tenant names come from solve options: past this many, idle tenants without a policy get dropped
+  static constexpr std::size_t kMaxTenants = 1000;
+
+  struct Tenant {
+    TenantPolicy policy;
+    std::int32_t running = 0;
+    std::int32_t waiting = 0;
+    std::int64_t completed = 0;
+    double virtualTime = 0; // Seconds of run time over weight
+    Clock::duration runTime{0};
+    Clock::duration quotaUsed{0};
+    std::deque<Clock::duration> latencies; // Most recent waits for a first core
+  };
+
+  Scheduler() = default;
+
+  void wait(Task& task, std::unique_lock<std::mutex>& lock) {
+    const auto waitStart = Clock::now();
+
+    auto& tenant = tenantOf(task);
+
+    waiting.push_back(&task);
+    tenant.waiting += 1;
+
+    // Quota periods end while waiting, too
+    for (renewQuotas(); policy.cores > 0 && next() != &task; renewQuotas())
+      changed.wait_until(lock, quotaStart + policy.quotaPeriod);
+
+    waiting.erase(std::find(waiting.begin(), waiting.end(), &task));
+    tenant.waiting -= 1;
+
+    running += 1;
+    tenant.running += 1;
+
+    task.sliceStart = Clock::now();
+    task.slice = policy.timeSlice;
+    task.waited += task.sliceStart - waitStart;
+
+    shrinkBudget(task);
+
+    // The next one up may fit on a core, too
+    changed.notify_all();
+  }
+
+  // Budgets only ever shrink: the queue backing up later still cuts searches short, a queue draining does not extend them.
+  // Scaled by 1 / (1 + waiting per core) and cut to the run time reaching the deadline, but never below the floor.
+  void shrinkBudget(Task& task) const {
+    if (policy.budgetFloor >= 1)
+      return;
+
+    const auto perCore = static_cast<double>(waiting.size()) / std::max(policy.cores, 1);
+    const auto byDepth = std::chrono::duration_cast<Clock::duration>(task.requested / (1 + perCore));
+    const auto byDeadline = task.ran + (task.deadline - task.sliceStart);
+    const auto floor = std::chrono::duration_cast<Clock::duration>(task.requested * policy.budgetFloor);
+
+    task.granted = std::min(task.granted, std::max(floor, std::min(byDepth, byDeadline)));
+  }
+
+  void release(Task& task) {
+    running -= 1;
+    tenantOf(task).running -= 1;
+  }
+
+  void charge(Task& task, Clock::time_point now) {
+    const auto elapsed = now - task.sliceStart;
+
+    task.ran += elapsed;
+    task.sliceStart = now;
+
+    auto& tenant = tenantOf(task);
+
+    tenant.runTime += elapsed;
+    tenant.quotaUsed += elapsed;
+    tenant.virtualTime += std::chrono::duration<double>(elapsed).count() / tenant.policy.weight;
+  }
+
+  // Waiting task to run next, nullptr if none may run right now
+  Task* next() const {
+    Task* best = nullptr;
+
+    for (auto* task : waiting)
+      if (eligible(*task) && (!best || before(*task, *best)))
+        best = task;
+
+    return best;
+  }
+
+  bool eligible(const Task& task) const {
+    const auto& tenant = tenantOf(task);
+
+    const auto coreFree = running < policy.cores;
+    const auto belowCap = tenant.policy.maxRunning == 0 || tenant.running < tenant.policy.maxRunning;
+    const auto withinQuota = tenant.policy.cpuQuota.count() == 0 || tenant.quotaUsed < tenant.policy.cpuQuota;
+
+    return coreFree && belowCap && withinQuota;
+  }
+
+  // Least served tenant first, then earliest deadline
+  bool before(const Task& lhs, const Task& rhs) const {
+    const auto lhsTime = tenantOf(lhs).virtualTime;
+    const auto rhsTime = tenantOf(rhs).virtualTime;
+
+    if (lhsTime != rhsTime)
+      return lhsTime < rhsTime;
+
+    return lhs.deadline < rhs.deadline || (lhs.deadline == rhs.deadline && lhs.sequence < rhs.sequence);
+  }
+
+  double minVirtualTime() const {
+    auto minTime = std::numeric_limits<double>::max();
+
+    for (const auto& it : tenants)
+      if (it.second.running + it.second.waiting > 0)
+        minTime = std::min(minTime, it.second.virtualTime);
+
+    return minTime == std::numeric_limits<double>::max() ? 0 : minTime;
+  }
+
+  void renewQuotas() {
+    const auto now = Clock::now();
+
+    if (now < quotaStart + policy.quotaPeriod)
+      return;
+
+    for (auto& tenant : tenants)
+      tenant.second.quotaUsed = Clock::duration{0};
+
+    quotaStart = now;
+  }
+
+  Tenant& tenantOf(const Task& task) {
+    auto it = tenants.find(task.tenantName);
+
+    if (it == tenants.end()) {
+      if (tenants.size() >= kMaxTenants)
+        dropIdleTenants();
+
+      it = tenants.emplace(task.tenantName, Tenant{}).first;
+      it->second.policy = policyFor(task.tenantName);
+    }
+
+    return it->second;
+  }
+
+  // Only the tenants' metrics get lost: coming back, a tenant starts over like a new one, see enter
+  void dropIdleTenants() {
+    for (auto it = tenants.begin(); it != tenants.end();) {
+      const auto idle = it->second.running + it->second.waiting == 0;
+      const auto configured = policy.tenants.count(it->first) > 0;
+
+      it = idle && !configured ? tenants.erase(it) : std::next(it);
+    }
+  }
+
+  // Tasks known to the scheduler always have their tenant set up, see above
+  const Tenant& tenantOf(const Task& task) const { return tenants.at(task.tenantName); }
+
+  TenantPolicy policyFor(const std::string& name) const {
+    const auto it = policy.tenants.find(name);
+    return it == policy.tenants.end() ? TenantPolicy{} : it->second;
+  }
+
+  static std::int64_t toMilliseconds(Clock::duration duration) {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(duration).count();
+  }
+
+  mutable std::mutex mutex;
+  std::condition_variable changed;
+
+  Policy policy;
+  Clock::time_point quotaStart = Clock::now();
+
+  std::int32_t running = 0;
+  std::uint64_t submitted = 0;
+  std::vector<Task*> waiting;
+
+  std::map<std::string, Tenant> tenants; // Stable addresses
+};
+
+// Yields to the scheduler from within the search and stops it once the task ran for its granted budget.
+// Time parked does not count: attach via RoutingModel::AddSearchMonitor and lift the search's own time limit.
+class ScheduledLimit final : public ort::SearchLimit {
+public:
+  ScheduledLimit(Solver* solver, Scheduler::Task& task_) : ort::SearchLimit(solver), task(task_) {}
+
+  bool Check() override {
+    Scheduler::get().yield(task);
+    return task.runTime() >= task.budget();
+  }
+
+  void Init() override {}
+
+  void Copy(const ort::SearchLimit*) override {}
+
+  ort::SearchLimit* MakeClone() const override { return solver()->RevAlloc(new ScheduledLimit{solver(), task}); }
+
+  std::string DebugString() const override { return "ScheduledLimit"; }
+
+private:
+  Scheduler::Task& task;
+};
+
+// Runs scheduled solves on threads of the scheduler's own instead of Node's thread pool: solves parked waiting for a core
+// block one of these, never a pool thread other asynchronous work needs. Threads start on demand and stay once idle.
+// Finished workers complete on the event loop via uv_async, as Nan::AsyncQueueWorker's workers do via the pool.
+class SchedulerThreads {
+public:
+  static SchedulerThreads& get();
+
+  // Takes ownership of the worker; event loop thread only
+  void queue(Nan::AsyncWorker* worker);
+
+private:
+  SchedulerThreads();
+
+  void run();
+  void complete();
+
+  std::mutex mutex;
+  std::condition_variable queued;
+
+  std::deque<Nan::AsyncWorker*> pending;
+  std::deque<Nan::AsyncWorker*> finished;
+  std::int32_t idle = 0;   // Threads waiting for work
+  std::int32_t wakeups = 0; // Pending workers promised to idle threads
+
+  std::int32_t outstanding = 0; // Event loop thread only: workers not completed yet keep the loop alive
+  uv_async_t async;
+};
+
+// Scheduled workers run on the scheduler's threads, all others on Node's thread pool
+inline void queueWorker(Nan::AsyncWorker* worker, bool scheduled) {
+  if (scheduled)
+    SchedulerThreads::get().queue(worker);
+  else
+    Nan::AsyncQueueWorker(worker);
+}
+
+// ortools.configureScheduler(options) and ortools.schedulerStats(), see API.md
+NAN_METHOD(ConfigureScheduler);
+NAN_METHOD(SchedulerStats);
+
+#endif
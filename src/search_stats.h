@@ -0,0 +1,41 @@
+#ifndef NODE_OR_TOOLS_SEARCH_STATS_5A1F3C8E92D4_H
+#define NODE_OR_TOOLS_SEARCH_STATS_5A1F3C8E92D4_H
+
+#include "ortools/constraint_solver/routing.h"
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "types.h"
+
+// What a search did, reported to the user alongside the solution
+struct SearchStats {
+  std::int64_t solutions = 0; // Solutions accepted by the search
+  std::int64_t wallTime = 0;  // Milliseconds spent solving
+  std::int64_t cpuTime = 0;   // Milliseconds of CPU time the solving thread spent
+  std::int64_t waitTime = 0;  // Milliseconds of wallTime parked by the scheduler, see scheduler.h
+  std::int64_t budget = 0;    // Milliseconds granted to search, less than the time limit under overload
+
+  // Per island the milliseconds into solving and cost of every improvement, empty without islands
+  std::vector<std::vector<std::pair<std::int64_t, std::int64_t>>> islands;
+};
+
+// Counts the solutions the search accepts; attach via RoutingModel::AddSearchMonitor before closing the model.
+class SolutionCounter final : public ort::SearchMonitor {
+public:
+  SolutionCounter(Solver* solver, SearchStats& stats_) : ort::SearchMonitor(solver), stats(stats_) {}
+
+  bool AtSolution() override {
+    stats.solutions += 1;
+    return ort::SearchMonitor::AtSolution();
+  }
+
+  std::string DebugString() const override { return "SolutionCounter"; }
+
+private:
+  SearchStats& stats;
+};
+
+#endif
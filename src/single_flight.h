@@ -0,0 +1,66 @@
+#ifndef NODE_OR_TOOLS_SINGLE_FLIGHT_2D7C5E9A04B8_H
+#define NODE_OR_TOOLS_SINGLE_FLIGHT_2D7C5E9A04B8_H
+
+#include <nan.h>
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// A solve in progress on the instance data, together with identical solves waiting for its result
+template <typename Instance> struct Flight {
+  Flight(std::string key_, Instance instance_) : key{std::move(key_)}, instance{std::move(instance_)} {}
+
+  const std::string key;
+  const Instance instance;
+  std::vector<std::unique_ptr<Nan::Callback>> followers;
+};
+
+// Identical concurrent solves share one worker: the first one solves, the others wait for its result.
+// Flights are keyed by the search options; solves only join a flight on the very same instance data.
+// Main thread only: flights start in Solve and land in the worker's callbacks, both run on the event loop.
+template <typename Instance> class SingleFlight {
+public:
+  static SingleFlight& get() {
+    static SingleFlight singleFlight;
+    return singleFlight;
+  }
+
+  // Flight in progress for the key on an instance `same` accepts, nullptr if there is none
+  template <typename Same> std::shared_ptr<Flight<Instance>> find(const std::string& key, Same same) const {
+    const auto range = flights.equal_range(key);
+
+    for (auto it = range.first; it != range.second; ++it)
+      if (same(it->second->instance))
+        return it->second;
+
+    return nullptr;
+  }
+
+  std::shared_ptr<Flight<Instance>> start(std::string key, Instance instance) {
+    auto flight = std::make_shared<Flight<Instance>>(key, std::move(instance));
+    flights.emplace(std::move(key), flight);
+    return flight;
+  }
+
+  // Solves from here on start a flight of their own
+  void land(const Flight<Instance>& flight) {
+    const auto range = flights.equal_range(flight.key);
+
+    for (auto it = range.first; it != range.second; ++it) {
+      if (it->second.get() == &flight) {
+        flights.erase(it);
+        return;
+      }
+    }
+  }
+
+private:
+  SingleFlight() = default;
+
+  std::unordered_multimap<std::string, std::shared_ptr<Flight<Instance>>> flights;
+};
+
+#endif
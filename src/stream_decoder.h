@@ -0,0 +1,143 @@
+#ifndef NODE_OR_TOOLS_STREAM_DECODER_7E21B04F9C3D_H
+#define NODE_OR_TOOLS_STREAM_DECODER_7E21B04F9C3D_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "types.h"
+
+// Binary instance layout: a sequence of sections with little-endian int32 values.
+//  - matrix sections hold numNodes rows of numNodes values, row `from` holding the values for all `to`
+//  - the time windows section holds numNodes [start, stop] pairs
+enum class StreamSection { Costs, Durations, TimeWindows, Demands };
+
+using StreamLayout = std::vector<StreamSection>;
+
+inline StreamSection makeStreamSectionFromName(const std::string& name) {
+  if (name == "costs")
+    return StreamSection::Costs;
+  if (name == "durations")
+    return StreamSection::Durations;
+  if (name == "timeWindows")
+    return StreamSection::TimeWindows;
+  if (name == "demands")
+    return StreamSection::Demands;
+
+  throw std::runtime_error{"Expected layout sections of 'costs', 'durations', 'timeWindows', 'demands'"};
+}
+
+inline StreamLayout makeDefaultStreamLayout() {
+  return {StreamSection::Costs, StreamSection::Durations, StreamSection::TimeWindows, StreamSection::Demands};
+}
+
+// Decodes chunks of a binary instance as they arrive, writing values straight into matrix storage.
+// Chunks can split values at arbitrary byte boundaries; there is no intermediate copy of the stream.
+class StreamDecoder {
+public:
+  StreamDecoder(std::int32_t numNodes_, StreamLayout layout_)
+      : numNodes{numNodes_}, layout{std::move(layout_)}, costs(numNodes_), durations(numNodes_), timeWindows(numNodes_),
+        demands(numNodes_) {
+
+    if (layout.size() != 4)
+      throw std::runtime_error{"Expected layout to contain each section exactly once"};
+
+    for (auto kind : makeDefaultStreamLayout())
+      if (std::count(layout.begin(), layout.end(), kind) != 1)
+        throw std::runtime_error{"Expected layout to contain each section exactly once"};
+
+    for (auto kind : layout)
+      total += sectionBytes(kind);
+
+    // Nothing to decode for empty instances
+    if (numNodes == 0)
+      section = layout.size();
+  }
+
+  // Consumes at most the bytes left in the layout, returns the number of bytes consumed
+  std::size_t feed(const char* bytes, std::size_t len) {
+    std::size_t consumed = 0;
+
+    while (consumed < len && !done()) {
+      pending[pendingBytes++] = static_cast<std::uint8_t>(bytes[consumed++]);
+
+      if (pendingBytes == sizeof(std::int32_t)) {
+        const auto word = static_cast<std::uint32_t>(pending[0])              //
+                          | static_cast<std::uint32_t>(pending[1]) << 8u    //
+                          | static_cast<std::uint32_t>(pending[2]) << 16u   //
+                          | static_cast<std::uint32_t>(pending[3]) << 24u;  //
+
+        put(static_cast<std::int32_t>(word));
+        pendingBytes = 0;
+      }
+    }
+
+    decoded += consumed;
+
+    return consumed;
+  }
+
+  bool done() const { return section == layout.size(); }
+
+  std::int64_t bytesDecoded() const { return decoded; }
+  std::int64_t totalBytes() const { return total; }
+
+  std::int32_t numNodes;
+  StreamLayout layout;
+
+  CostMatrix costs;
+  DurationMatrix durations;
+  TimeWindows timeWindows;
+  DemandMatrix demands;
+
+private:
+  std::int64_t sectionValues(StreamSection kind) const {
+    const auto n = static_cast<std::int64_t>(numNodes);
+    return kind == StreamSection::TimeWindows ? 2 * n : n * n;
+  }
+
+  std::int64_t sectionBytes(StreamSection kind) const { return sectionValues(kind) * sizeof(std::int32_t); }
+
+  void put(std::int32_t value) {
+    const auto kind = layout[section];
+
+    switch (kind) {
+    case StreamSection::Costs:
+      costs.at(offset / numNodes, offset % numNodes) = value;
+      break;
+    case StreamSection::Durations:
+      durations.at(offset / numNodes, offset % numNodes) = value;
+      break;
+    case StreamSection::Demands:
+      demands.at(offset / numNodes, offset % numNodes) = value;
+      break;
+    case StreamSection::TimeWindows:
+      if (offset % 2 == 0)
+        start = value;
+      else
+        timeWindows.at(offset / 2) = Interval{start, value};
+      break;
+    }
+
+    if (++offset == sectionValues(kind)) {
+      section += 1;
+      offset = 0;
+    }
+  }
+
+  std::size_t section = 0;
+  std::int64_t offset = 0;
+  std::int32_t start = 0;
+
+  std::uint8_t pending[sizeof(std::int32_t)];
+  std::size_t pendingBytes = 0;
+
+  std::int64_t decoded = 0;
+  std::int64_t total = 0;
+};
+
+#endif
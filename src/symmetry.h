@@ -0,0 +1,95 @@
+#ifndef NODE_OR_TOOLS_SYMMETRY_5C8E1A3F92D4_H
+#define NODE_OR_TOOLS_SYMMETRY_5C8E1A3F92D4_H
+
+#include "ortools/constraint_solver/routing.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "types.h"
+
+// How solutions differing only in which of several identical vehicles serves a route get pruned:
+//  - None: every labelling gets searched
+//  - EmptyRoutes: among identical vehicles, empty routes come last
+//  - FirstNodes: among identical vehicles, routes are ordered by their first location; empty routes come last
+enum class SymmetryBreaking { None, EmptyRoutes, FirstNodes };
+
+inline SymmetryBreaking makeSymmetryBreakingFromName(const std::string& name) {
+  if (name == "none")
+    return SymmetryBreaking::None;
+  if (name == "emptyRoutes")
+    return SymmetryBreaking::EmptyRoutes;
+  if (name == "firstNodes")
+    return SymmetryBreaking::FirstNodes;
+
+  throw std::runtime_error{"Expected symmetryBreaking of 'none', 'emptyRoutes' or 'firstNodes'"};
+}
+
+// Vehicles with equal signatures, in ascending order; only groups of two or more vehicles
+inline std::vector<std::vector<std::int32_t>> groupIdenticalVehicles(const std::vector<std::vector<int64>>& signatures) {
+  std::map<std::vector<int64>, std::vector<std::int32_t>> groups;
+
+  for (std::int32_t vehicle = 0; vehicle < (std::int32_t)signatures.size(); ++vehicle)
+    groups[signatures[vehicle]].push_back(vehicle);
+
+  std::vector<std::vector<std::int32_t>> identical;
+
+  for (auto& group : groups)
+    if (group.second.size() > 1)
+      identical.push_back(std::move(group.second));
+
+  return identical;
+}
+
+// Orders each group's vehicles by the index they leave their start for. Unused vehicles go straight to their end,
+// and ends come after all other indices in increasing vehicle order: empty routes sort last on their own.
+// Call before closing the model, groups as by groupIdenticalVehicles.
+inline void addSymmetryBreaking(RoutingModel& model, const std::vector<std::vector<std::int32_t>>& groups,
+                                SymmetryBreaking mode) {
+  auto* solver = model.solver();
+
+  for (const auto& group : groups) {
+    for (std::size_t at = 1; at < group.size(); ++at) {
+      auto* previous = model.NextVar(model.Start(group[at - 1]));
+      auto* next = model.NextVar(model.Start(group[at]));
+
+      if (mode == SymmetryBreaking::FirstNodes) {
+        solver->AddConstraint(solver->MakeLess(previous, next));
+      } else if (mode == SymmetryBreaking::EmptyRoutes) {
+        auto* previousUsed = solver->MakeIsDifferentCstVar(previous, model.End(group[at - 1]));
+        auto* nextUsed = solver->MakeIsDifferentCstVar(next, model.End(group[at]));
+
+        solver->AddConstraint(solver->MakeGreaterOrEqual(previousUsed, nextUsed));
+      }
+    }
+  }
+}
+
+// Reassigns routes within each group the way addSymmetryBreaking orders them, e.g. for starting from a known solution
+inline void orderRoutes(const RoutingModel& model, const std::vector<std::vector<std::int32_t>>& groups,
+                        std::vector<std::vector<NodeIndex>>& routes) {
+  for (const auto& group : groups) {
+    std::vector<std::vector<NodeIndex>> ordered;
+
+    for (const auto vehicle : group)
+      ordered.push_back(std::move(routes[vehicle]));
+
+    const auto firstIndex = [&](const std::vector<NodeIndex>& route) {
+      return route.empty() ? std::numeric_limits<int64>::max() : model.NodeToIndex(route.front());
+    };
+
+    std::stable_sort(ordered.begin(), ordered.end(), [&](const std::vector<NodeIndex>& lhs, const std::vector<NodeIndex>& rhs) {
+      return firstIndex(lhs) < firstIndex(rhs);
+    });
+
+    for (std::size_t at = 0; at < group.size(); ++at)
+      routes[group[at]] = std::move(ordered[at]);
+  }
+}
+
+#endif
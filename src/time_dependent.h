@@ -0,0 +1,224 @@
+#ifndef NODE_OR_TOOLS_TIME_DEPENDENT_4C9D1E7A2B63_H
+#define NODE_OR_TOOLS_TIME_DEPENDENT_4C9D1E7A2B63_H
+
+#include "ortools/constraint_solver/constraint_solveri.h"
+#include "ortools/constraint_solver/routing.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "types.h"
+
+// Travel durations depending on the departure time: one duration matrix per departure time slice.
+//  - Linear: interpolates between the matrices of adjacent slices
+//  - Step: uses the slice's matrix but never arrives later than departing in a later slice would
+// Both keep arrival times non-decreasing in departure times (FIFO), which the solver relies on.
+class TimeDependentDurations {
+public:
+  enum class Interpolation { Linear, Step };
+
+  TimeDependentDurations() = default;
+
+  TimeDependentDurations(std::vector<std::int32_t> departures_, std::vector<DurationMatrix> matrices_, Interpolation interpolation_)
+      : departures{std::move(departures_)}, matrices{std::move(matrices_)}, interpolation{interpolation_} {
+
+    if (departures.empty() || departures.size() != matrices.size())
+      throw std::runtime_error{"Expected one duration matrix per departure time"};
+
+    for (std::size_t slice = 1; slice < departures.size(); ++slice)
+      if (departures[slice - 1] >= departures[slice])
+        throw std::runtime_error{"Expected departure times in strictly increasing order"};
+
+    for (const auto& matrix : matrices)
+      if (matrix.dim() != matrices.front().dim())
+        throw std::runtime_error{"Expected duration matrices of the same size"};
+
+    // Linear interpolation with a slope of -1 or less lets later departures overtake earlier ones
+    if (interpolation == Interpolation::Linear) {
+      const auto n = matrices.front().dim();
+
+      for (std::size_t slice = 1; slice < departures.size(); ++slice)
+        for (std::int32_t from = 0; from < n; ++from)
+          for (std::int32_t to = 0; to < n; ++to)
+            if (matrices[slice - 1].at(from, to) - matrices[slice].at(from, to) >= departures[slice] - departures[slice - 1])
+              throw std::runtime_error{"Expected duration changes between departure times not to break FIFO"};
+    }
+  }
+
+  bool empty() const { return matrices.empty(); }
+
+  void compress() {
+    for (auto& matrix : matrices)
+      matrix.compress();
+  }
+
+  std::int32_t dim() const { return empty() ? 0 : matrices.front().dim(); }
+
+  // Same departures, matrices and interpolation, see single_flight.h
+  bool same(const TimeDependentDurations& other) const {
+    if (interpolation != other.interpolation || departures != other.departures || matrices.size() != other.matrices.size())
+      return false;
+
+    for (std::size_t slice = 0; slice < matrices.size(); ++slice)
+      if (!sameMatrix(matrices[slice], other.matrices[slice]))
+        return false;
+
+    return true;
+  }
+
+  std::int32_t bytes() const {
+    std::int32_t bytes = departures.size() * sizeof(std::int32_t);
+
+    for (const auto& matrix : matrices)
+      bytes += matrix.bytes();
+
+    return bytes;
+  }
+
+  // Arrival time at `to` when departing `from` at `departure`, service time at `from` included
+  std::int64_t arrival(std::int32_t from, std::int32_t to, std::int64_t departure) const {
+    const auto slice = sliceAt(departure);
+
+    if (interpolation == Interpolation::Step) {
+      auto best = departure + matrices[slice].at(from, to);
+
+      for (auto later = slice + 1; later < departures.size(); ++later)
+        best = std::min(best, static_cast<std::int64_t>(departures[later]) + matrices[later].at(from, to));
+
+      return best;
+    }
+
+    if (departure <= departures.front() || slice + 1 == departures.size())
+      return departure + matrices[slice].at(from, to);
+
+    const std::int64_t lo = matrices[slice].at(from, to);
+    const std::int64_t hi = matrices[slice + 1].at(from, to);
+    const std::int64_t offset = departure - departures[slice];
+    const std::int64_t width = departures[slice + 1] - departures[slice];
+
+    return departure + lo + (hi - lo) * offset / width;
+  }
+
+  // Latest departure in [earliest, latest] still arriving by `deadline`, or earliest - 1 if there is none
+  std::int64_t latestDeparture(std::int32_t from, std::int32_t to, std::int64_t deadline, std::int64_t earliest,
+                               std::int64_t latest) const {
+    if (arrival(from, to, earliest) > deadline)
+      return earliest - 1;
+
+    // Arrivals are non-decreasing in departures: binary search the last feasible departure
+    while (earliest < latest) {
+      const auto mid = earliest + (latest - earliest + 1) / 2;
+
+      if (arrival(from, to, mid) <= deadline)
+        earliest = mid;
+      else
+        latest = mid - 1;
+    }
+
+    return earliest;
+  }
+
+  // Per-arc lower bounds over all departure times, used as the dimension's static transits
+  DurationMatrix makeLowerBounds() const {
+    const auto n = dim();
+
+    DurationMatrix bounds(n);
+
+    for (std::int32_t from = 0; from < n; ++from) {
+      for (std::int32_t to = 0; to < n; ++to) {
+        auto lowest = std::numeric_limits<std::int32_t>::max();
+
+        for (const auto& matrix : matrices)
+          lowest = std::min(lowest, matrix.at(from, to));
+
+        bounds.at(from, to) = lowest;
+      }
+    }
+
+    return bounds;
+  }
+
+private:
+  std::size_t sliceAt(std::int64_t departure) const {
+    const auto it = std::upper_bound(departures.begin(), departures.end(), departure);
+    return it == departures.begin() ? 0 : std::distance(departures.begin(), it) - 1;
+  }
+
+  std::vector<std::int32_t> departures;
+  std::vector<DurationMatrix> matrices;
+  Interpolation interpolation = Interpolation::Linear;
+};
+
+// Links the cumul of a node to the cumul of its successor through the departure-dependent durations.
+// The dimension's static transits are lower bounds; slack absorbs the difference.
+class TimeDependentTransitConstraint final : public ort::Constraint {
+public:
+  TimeDependentTransitConstraint(Solver* solver, const RoutingModel& model_, const ort::RoutingDimension& dimension_,
+                                 const TimeDependentDurations& durations_, int64 index_)
+      : ort::Constraint(solver), model(model_), dimension(dimension_), durations(durations_), index{index_} {}
+
+  void Post() override {
+    demon = ort::MakeConstraintDemon0(solver(), this, &TimeDependentTransitConstraint::Propagate, "Propagate");
+
+    auto* nextBound = ort::MakeConstraintDemon0(solver(), this, &TimeDependentTransitConstraint::WatchNext, "WatchNext");
+
+    model.NextVar(index)->WhenBound(nextBound);
+    dimension.CumulVar(index)->WhenRange(demon);
+  }
+
+  void InitialPropagate() override {
+    if (model.NextVar(index)->Bound())
+      WatchNext();
+    else
+      Propagate();
+  }
+
+  // Once the successor is known its cumul bounds ours, too: watch it. Demons attached in search get undone on backtrack.
+  void WatchNext() {
+    auto* next = model.NextVar(index);
+
+    if (next->Min() != index)
+      dimension.CumulVar(next->Min())->WhenRange(demon);
+
+    Propagate();
+  }
+
+  void Propagate() {
+    auto* next = model.NextVar(index);
+
+    if (!next->Bound() || next->Min() == index)
+      return;
+
+    const auto nextIndex = next->Min();
+
+    const auto from = model.IndexToNode(index).value();
+    const auto to = model.IndexToNode(nextIndex).value();
+
+    auto* cumul = dimension.CumulVar(index);
+    auto* nextCumul = dimension.CumulVar(nextIndex);
+
+    nextCumul->SetMin(durations.arrival(from, to, cumul->Min()));
+    cumul->SetMax(durations.latestDeparture(from, to, nextCumul->Max(), cumul->Min(), cumul->Max()));
+  }
+
+  std::string DebugString() const override { return "TimeDependentTransitConstraint"; }
+
+private:
+  const RoutingModel& model;
+  const ort::RoutingDimension& dimension;
+  const TimeDependentDurations& durations;
+  const int64 index;
+  ort::Demon* demon = nullptr;
+};
+
+template <> struct Bytes<TimeDependentDurations> {
+  std::int32_t operator()(const TimeDependentDurations& v) const { return v.bytes(); }
+};
+
+#endif
@@ -34,6 +34,9 @@ NAN_METHOD(TSP::New) try {
 
   TSPSolverParams userParams{info};
 
+  if (userParams.compressMatrices)
+    userParams.costs.compress();
+
   const auto bytesChange = getBytes(userParams.costs);
   Nan::AdjustExternalMemory(bytesChange);
 
@@ -72,8 +75,10 @@ NAN_METHOD(TSP::Solve) try {
                                searchParams,                           //
                                numNodes,                               //
                                numVehicles,                            //
-                               userParams.depotNode};                  //
-  Nan::AsyncQueueWorker(worker);
+                               userParams.depotNode,                   //
+                               std::move(userParams.tenant),           //
+                               userParams.cpuTimeLimit};               //
+  queueWorker(worker, worker->scheduled);
 
 } catch (const std::exception& e) {
   return Nan::ThrowError(e.what());
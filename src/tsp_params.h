@@ -4,6 +4,7 @@
 #include <nan.h>
 
 #include <stdexcept>
+#include <string>
 
 #include "params.h"
 
@@ -12,6 +13,8 @@ struct TSPSolverParams {
 
   std::int32_t numNodes;
   CostMatrix costs;
+
+  bool compressMatrices;
 };
 
 struct TSPSearchParams {
@@ -19,6 +22,8 @@ struct TSPSearchParams {
 
   std::int32_t computeTimeLimit;
   std::int32_t depotNode;
+  std::string tenant;
+  std::int32_t cpuTimeLimit;
 
   v8::Local<v8::Function> callback;
 };
@@ -44,6 +49,8 @@ TSPSolverParams::TSPSolverParams(const Nan::FunctionCallbackInfo<v8::Value>& inf
 
   auto costMatrix = maybeCostMatrix.ToLocalChecked().As<v8::Array>();
   costs = makeMatrixFrom2dArray<CostMatrix>(numNodes, costMatrix);
+
+  compressMatrices = makeCompressMatricesFromOptions(opts);
 }
 
 TSPSearchParams::TSPSearchParams(const Nan::FunctionCallbackInfo<v8::Value>& info) {
@@ -63,6 +70,29 @@ TSPSearchParams::TSPSearchParams(const Nan::FunctionCallbackInfo<v8::Value>& inf
 
   computeTimeLimit = Nan::To<std::int32_t>(maybeComputeTimeLimit.ToLocalChecked()).FromJust();
   depotNode = Nan::To<std::int32_t>(maybeDepotNode.ToLocalChecked()).FromJust();
+
+  // Optional: milliseconds of CPU time to search for, computeTimeLimit stays a limit on wall time
+  auto maybeCpuTimeLimit = Nan::Get(opts, Nan::New("cpuTimeLimit").ToLocalChecked());
+
+  cpuTimeLimit = 0;
+
+  if (!maybeCpuTimeLimit.IsEmpty() && !maybeCpuTimeLimit.ToLocalChecked()->IsUndefined()) {
+    if (!maybeCpuTimeLimit.ToLocalChecked()->IsNumber())
+      throw std::runtime_error{"SearchOptions expects 'cpuTimeLimit' (Number)"};
+
+    cpuTimeLimit = Nan::To<std::int32_t>(maybeCpuTimeLimit.ToLocalChecked()).FromJust();
+  }
+
+  // Optional: tenant sharing the scheduler's cores with others, see configureScheduler
+  auto maybeTenant = Nan::Get(opts, Nan::New("tenant").ToLocalChecked());
+
+  if (!maybeTenant.IsEmpty() && !maybeTenant.ToLocalChecked()->IsUndefined()) {
+    if (!maybeTenant.ToLocalChecked()->IsString())
+      throw std::runtime_error{"SearchOptions expects 'tenant' (String)"};
+
+    tenant = *Nan::Utf8String{maybeTenant.ToLocalChecked()};
+  }
+
   callback = info[1].As<v8::Function>();
 }
 
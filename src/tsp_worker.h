@@ -4,9 +4,15 @@
 #include <nan.h>
 
 #include "adaptors.h"
+#include "cpu_time.h"
+#include "scheduler.h"
+#include "search_stats.h"
 #include "types.h"
 
+#include <chrono>
+#include <limits>
 #include <memory>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -15,9 +21,10 @@ struct TSPWorker final : Nan::AsyncWorker {
 
   TSPWorker(std::shared_ptr<const CostMatrix> costs_, Nan::Callback* callback, const RoutingModelParameters& modelParams_,
             const RoutingSearchParameters& searchParams_, std::int32_t numNodes, std::int32_t numVehicles,
-            std::int32_t vehicleDepot)
+            std::int32_t vehicleDepot, std::string tenant_, std::int32_t cpuTimeLimit_)
       : Base(callback), costs{std::move(costs_)}, model{numNodes, numVehicles, NodeIndex{vehicleDepot}, modelParams_},
-        modelParams{modelParams_}, searchParams{searchParams_} {}
+        modelParams{modelParams_}, searchParams{searchParams_}, tenant{std::move(tenant_)},
+        cpuTimeLimit{cpuTimeLimit_}, submitted{Scheduler::Clock::now()}, scheduled{Scheduler::get().enabled()} {}
 
   void Execute() override {
     auto costAdaptor = makeBinaryAdaptor(*costs);
@@ -25,10 +32,52 @@ struct TSPWorker final : Nan::AsyncWorker {
 
     model.SetArcCostEvaluatorOfAllVehicles(costEvaluator);
 
-    const auto* assignment = model.SolveWithParameters(searchParams);
+    auto* solver = model.solver();
+
+    if (cpuTimeLimit > 0) {
+      const auto cpuDeadline = threadCpuTime() + std::chrono::milliseconds(cpuTimeLimit);
+      model.AddSearchMonitor(solver->RevAlloc(new CpuTimeLimit{solver, cpuDeadline}));
+    }
+
+    // Interleaved with other solves once the scheduler is on, see scheduler.h
+    Scheduler::Task task{submitted, std::chrono::milliseconds(searchParams.time_limit_ms()), tenant};
+
+    if (scheduled)
+      solveScheduled(task);
+    else
+      solve(searchParams);
+
+    // Granted on admission, less than the time limit under overload
+    stats.budget = std::chrono::duration_cast<std::chrono::milliseconds>(task.budget()).count();
+    stats.waitTime = std::chrono::duration_cast<std::chrono::milliseconds>(task.waitTime()).count();
+  }
+
+  void solveScheduled(Scheduler::Task& task) {
+    auto* solver = model.solver();
+
+    Scheduler::Slot slot{task};
+
+    model.AddSearchMonitor(solver->RevAlloc(new ScheduledLimit{solver, task}));
+
+    // Run time is what counts, see ScheduledLimit
+    auto params = searchParams;
+    params.set_time_limit_ms(std::numeric_limits<std::int32_t>::max());
+
+    solve(params);
+  }
+
+  void solve(const RoutingSearchParameters& params) {
+    const auto solveStart = std::chrono::steady_clock::now();
+    const auto solveStartCpu = threadCpuTime();
+
+    const auto* assignment = model.SolveWithParameters(params);
+
+    const auto solveTime = std::chrono::steady_clock::now() - solveStart;
+    stats.wallTime = std::chrono::duration_cast<std::chrono::milliseconds>(solveTime).count();
+    stats.cpuTime = std::chrono::duration_cast<std::chrono::milliseconds>(threadCpuTime() - solveStartCpu).count();
 
     if (!assignment || (model.status() != RoutingModel::Status::ROUTING_SUCCESS))
-      SetErrorMessage("Unable to find a solution");
+      return SetErrorMessage("Unable to find a solution");
 
     model.AssignmentToRoutes(*assignment, &routes);
 
@@ -46,6 +95,16 @@ struct TSPWorker final : Nan::AsyncWorker {
     for (std::size_t j = 0; j < route.size(); ++j)
       (void)Nan::Set(jsRoute, j, Nan::New<v8::Number>(route[j].value()));
 
+    // On the route itself, which stays an Array of locations
+    auto jsStats = Nan::New<v8::Object>();
+
+    (void)Nan::Set(jsStats, Nan::New("wallTime").ToLocalChecked(), Nan::New<v8::Number>(stats.wallTime));
+    (void)Nan::Set(jsStats, Nan::New("cpuTime").ToLocalChecked(), Nan::New<v8::Number>(stats.cpuTime));
+    (void)Nan::Set(jsStats, Nan::New("waitTime").ToLocalChecked(), Nan::New<v8::Number>(stats.waitTime));
+    (void)Nan::Set(jsStats, Nan::New("budget").ToLocalChecked(), Nan::New<v8::Number>(stats.budget));
+
+    (void)Nan::Set(jsRoute, Nan::New("stats").ToLocalChecked(), jsStats);
+
     const auto argc = 2u;
     v8::Local<v8::Value> argv[argc] = {Nan::Null(), jsRoute};
 
@@ -58,8 +117,21 @@ struct TSPWorker final : Nan::AsyncWorker {
   RoutingModelParameters modelParams;
   RoutingSearchParameters searchParams;
 
+  // Shares the scheduler's cores with other tenants, see scheduler.h
+  std::string tenant;
+
+  // Milliseconds of CPU time, zero for no limit; see cpu_time.h
+  std::int32_t cpuTimeLimit;
+
+  // Deadline for the scheduler is submission plus time limit
+  const Scheduler::Clock::time_point submitted;
+
+  // Decided on submission: scheduled solves run on the scheduler's threads, see queueWorker
+  const bool scheduled;
+
   // Stores solution until we can translate back to v8 objects
   std::vector<std::vector<NodeIndex>> routes;
+  SearchStats stats;
 };
 
 #endif
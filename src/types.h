@@ -4,6 +4,11 @@
 #include "ortools/constraint_solver/routing.h"
 
 #include <cstdint>
+#include <limits>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include "matrix.h"
 #include "vector.h"
@@ -21,6 +26,29 @@ template <typename T, typename Tag> struct NewType {
 using CostMatrix = NewType<Matrix<std::int32_t>, struct CostMatrixTag>::Type;
 using DurationMatrix = NewType<Matrix<std::int32_t>, struct DurationMatrixTag>::Type;
 using DemandMatrix = NewType<Matrix<std::int32_t>, struct DemandMatrixTag>::Type;
+using DistanceMatrix = NewType<Matrix<std::int32_t>, struct DistanceMatrixTag>::Type;
+
+using DemandVector = NewType<Vector<std::int32_t>, struct DemandVectorTag>::Type;
+
+// Demands for a named resource such as weight or volume: per node or, as DemandMatrix, per arc.
+struct ResourceDemands {
+  ResourceDemands(std::string name_, DemandMatrix arcs_) : name{std::move(name_)}, arcs{std::move(arcs_)}, perArc{true} {}
+  ResourceDemands(std::string name_, DemandVector nodes_) : name{std::move(name_)}, nodes{std::move(nodes_)}, perArc{false} {}
+
+  std::int32_t dim() const { return perArc ? arcs.dim() : nodes.size(); }
+
+  std::int32_t at(std::int32_t from, std::int32_t to) const { return perArc ? arcs.at(from, to) : nodes.at(from); }
+
+  std::string name;
+  DemandMatrix arcs;
+  DemandVector nodes;
+  bool perArc;
+};
+
+using Resources = std::vector<ResourceDemands>;
+
+// Per-vehicle capacities keyed by resource name
+using ResourceCapacities = std::map<std::string, std::vector<int64>>;
 
 struct Interval {
   Interval() : start{0}, stop{0} {}
@@ -36,6 +64,29 @@ struct Interval {
 
 using TimeWindows = NewType<Vector<Interval>, struct TimeWindowsTag>::Type;
 
+// Serving a node before start or after stop costs the penalty per time unit early or late.
+// Unlike time windows these never make a problem infeasible; zero penalties leave the node as it is.
+struct SoftTimeWindow {
+  std::int32_t start = 0;
+  std::int32_t stop = 0;
+  std::int32_t earlyPenalty = 0;
+  std::int32_t latePenalty = 0;
+
+  bool penalized() const { return earlyPenalty > 0 || latePenalty > 0; }
+};
+
+using SoftTimeWindows = NewType<Vector<SoftTimeWindow>, struct SoftTimeWindowsTag>::Type;
+
+// Working hours per vehicle, applied to the time at route starts and ends without extra nodes:
+//  - windows[i] holds when vehicle i may leave and has to be back (empty for the time horizon for all)
+//  - maxRouteDuration limits the time between leaving and getting back
+//  - spanCost is added per time unit between leaving and getting back
+struct VehicleShifts {
+  std::vector<Interval> windows;
+  std::int32_t maxRouteDuration = std::numeric_limits<std::int32_t>::max();
+  std::int32_t spanCost = 0;
+};
+
 namespace ort = operations_research;
 
 // See routing.h
@@ -69,20 +120,61 @@ using RouteLocks = std::vector<LockChain>;
 using Pickups = NewType<Vector<NodeIndex>, struct PickupsTag>::Type;
 using Deliveries = NewType<Vector<NodeIndex>, struct DeliveriesTag>::Type;
 
+// Vehicles allowed to serve a node, e.g. refrigerated trucks only, packed into a single array:
+//  - vehicles for node i are vehicles[offsets[i], offsets[i + 1])
+//  - nodes without vehicles are not restricted; empty for no restrictions at all
+class AllowedVehicles {
+public:
+  // Appends the next node's vehicles, none for any vehicle
+  void append(const std::vector<int64>& nodeVehicles) {
+    vehicles.insert(vehicles.end(), nodeVehicles.begin(), nodeVehicles.end());
+    offsets.push_back(vehicles.size());
+  }
+
+  std::int32_t size() const { return offsets.size() - 1; }
+
+  bool restricted(std::int32_t node) const { return offsets[node + 1] != offsets[node]; }
+
+  std::vector<int64> at(std::int32_t node) const {
+    return std::vector<int64>(vehicles.begin() + offsets[node], vehicles.begin() + offsets[node + 1]);
+  }
+
+private:
+  std::vector<std::int32_t> offsets{0};
+  std::vector<int64> vehicles;
+};
+
+// Element-wise equality, no matter how either matrix is stored
+template <typename Matrix> bool sameMatrix(const Matrix& lhs, const Matrix& rhs) {
+  if (lhs.dim() != rhs.dim())
+    return false;
+
+  for (std::int32_t from = 0; from < lhs.dim(); ++from)
+    for (std::int32_t to = 0; to < lhs.dim(); ++to)
+      if (lhs.at(from, to) != rhs.at(from, to))
+        return false;
+
+  return true;
+}
+
 // Bytes in our type used for internal caching
 
 template <typename T> struct Bytes;
 
 template <> struct Bytes<CostMatrix> {
-  std::int32_t operator()(const CostMatrix& v) const { return v.size() * sizeof(CostMatrix::Value); }
+  std::int32_t operator()(const CostMatrix& v) const { return v.bytes(); }
 };
 
 template <> struct Bytes<DurationMatrix> {
-  std::int32_t operator()(const DurationMatrix& v) const { return v.size() * sizeof(DurationMatrix::Value); }
+  std::int32_t operator()(const DurationMatrix& v) const { return v.bytes(); }
 };
 
 template <> struct Bytes<DemandMatrix> {
-  std::int32_t operator()(const DemandMatrix& v) const { return v.size() * sizeof(DemandMatrix::Value); }
+  std::int32_t operator()(const DemandMatrix& v) const { return v.bytes(); }
+};
+
+template <> struct Bytes<DistanceMatrix> {
+  std::int32_t operator()(const DistanceMatrix& v) const { return v.bytes(); }
 };
 
 template <> struct Bytes<TimeWindows> {
@@ -108,6 +200,17 @@ template <> struct Bytes<Deliveries> {
   std::int32_t operator()(const Deliveries& v) const { return v.size() * sizeof(Deliveries::Value); }
 };
 
+template <> struct Bytes<Resources> {
+  std::int32_t operator()(const Resources& v) const {
+    std::int32_t bytes = 0;
+
+    for (const auto& resource : v)
+      bytes += resource.arcs.bytes() + resource.nodes.size() * sizeof(DemandVector::Value);
+
+    return bytes;
+  }
+};
+
 template <typename T> std::int32_t getBytes(const T& v) { return Bytes<T>{}(v); }
 
 #endif
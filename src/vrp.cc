@@ -1,12 +1,21 @@
 #include "vrp.h"
+#include "generator.h"
 #include "vrp_params.h"
+#include "vrp_search_config.h"
+#include "vrp_stream.h"
 #include "vrp_worker.h"
 
-VRP::VRP(CostMatrix costs_, DurationMatrix durations_, TimeWindows timeWindows_, DemandMatrix demands_)
+#include <string>
+
+VRP::VRP(CostMatrix costs_, DurationMatrix durations_, TimeWindows timeWindows_, DemandMatrix demands_,
+         TimeDependentDurations timeDependentDurations_, Resources resources_, DistanceMatrix distances_)
     : costs{std::make_shared<const CostMatrix>(std::move(costs_))},
       durations{std::make_shared<const DurationMatrix>(std::move(durations_))},
       timeWindows{std::make_shared<const TimeWindows>(std::move(timeWindows_))},
-      demands{std::make_shared<const DemandMatrix>(std::move(demands_))} {}
+      demands{std::make_shared<const DemandMatrix>(std::move(demands_))},
+      timeDependentDurations{std::make_shared<const TimeDependentDurations>(std::move(timeDependentDurations_))},
+      resources{std::make_shared<const Resources>(std::move(resources_))},
+      distances{std::make_shared<const DistanceMatrix>(std::move(distances_))} {}
 
 NAN_MODULE_INIT(VRP::Init) {
   const auto whoami = Nan::New("VRP").ToLocalChecked();
@@ -20,9 +29,50 @@ NAN_MODULE_INIT(VRP::Init) {
   const auto fn = Nan::GetFunction(fnTp).ToLocalChecked();
   constructor().Reset(fn);
 
+  // Native ingestion entry points, see lib/index.js for VRP.fromStream on top of them
+  Nan::SetMethod(fn, "fromFd", VRPStream::FromFd);
+  Nan::SetMethod(fn, "generate", Generate);
+  VRPStream::Init(fn);
+
+  // Search options parsed once for many solves
+  VRPSearchConfig::Init(fn);
+
   Nan::Set(target, whoami, fn);
 }
 
+// Set only while NewInstance constructs: an External from anywhere else is not a VRPData to take over
+static bool constructingNatively = false;
+
+v8::Local<v8::Object> VRP::NewInstance(VRPData data) {
+  Nan::EscapableHandleScope scope;
+
+  const auto argc = 1u;
+  v8::Local<v8::Value> argv[argc] = {Nan::New<v8::External>(&data)};
+
+  Nan::TryCatch tryCatch;
+
+  auto init = Nan::New(constructor());
+
+  constructingNatively = true;
+  auto maybeInstance = Nan::NewInstance(init, argc, argv);
+  constructingNatively = false;
+
+  if (maybeInstance.IsEmpty())
+    throw std::runtime_error{*Nan::Utf8String(tryCatch.Exception())};
+
+  return scope.Escape(maybeInstance.ToLocalChecked());
+}
+
+// Matrices of zeros constrain nothing: we drop them so the worker can skip their dimensions
+template <typename Matrix> static bool isZeroMatrix(const Matrix& matrix) {
+  for (std::int32_t from = 0; from < matrix.dim(); ++from)
+    for (std::int32_t to = 0; to < matrix.dim(); ++to)
+      if (matrix.at(from, to) != 0)
+        return false;
+
+  return true;
+}
+
 NAN_METHOD(VRP::New) try {
   // Handle `new T()` as well as `T()`
   if (!info.IsConstructCall()) {
@@ -31,19 +81,51 @@ NAN_METHOD(VRP::New) try {
     return;
   }
 
-  VRPSolverParams userParams{info};
+  // Natively constructed data is handed over as External, see VRP::NewInstance
+  VRPData userParams;
+
+  if (constructingNatively && info.Length() == 1 && info[0]->IsExternal()) {
+    constructingNatively = false;
+    userParams = std::move(*static_cast<VRPData*>(info[0].As<v8::External>()->Value()));
+  } else {
+    userParams = VRPSolverParams{info};
+  }
+
+  if (isZeroMatrix(userParams.durations) && userParams.timeDependentDurations.empty())
+    userParams.durations = DurationMatrix{};
+
+  if (isZeroMatrix(userParams.demands))
+    userParams.demands = DemandMatrix{};
+
+  if (userParams.compressMatrices) {
+    userParams.costs.compress();
+    userParams.durations.compress();
+    userParams.demands.compress();
+    userParams.timeDependentDurations.compress();
+    userParams.distances.compress();
+
+    for (auto& resource : userParams.resources)
+      if (resource.perArc)
+        resource.arcs.compress();
+  }
 
-  const auto bytesChange = getBytes(userParams.costs)         //
-                           + getBytes(userParams.durations)   //
-                           + getBytes(userParams.timeWindows) //
-                           + getBytes(userParams.demands);    //
+  const auto bytesChange = getBytes(userParams.costs)                    //
+                           + getBytes(userParams.durations)              //
+                           + getBytes(userParams.timeWindows)            //
+                           + getBytes(userParams.demands)                //
+                           + getBytes(userParams.timeDependentDurations) //
+                           + getBytes(userParams.resources)              //
+                           + getBytes(userParams.distances);             //
 
   Nan::AdjustExternalMemory(bytesChange);
 
-  auto* self = new VRP{std::move(userParams.costs),       //
-                       std::move(userParams.durations),   //
-                       std::move(userParams.timeWindows), //
-                       std::move(userParams.demands)};    //
+  auto* self = new VRP{std::move(userParams.costs),                   //
+                       std::move(userParams.durations),               //
+                       std::move(userParams.timeWindows),             //
+                       std::move(userParams.demands),                 //
+                       std::move(userParams.timeDependentDurations),  //
+                       std::move(userParams.resources),               //
+                       std::move(userParams.distances)};              //
 
   self->Wrap(info.This());
 
@@ -56,10 +138,42 @@ NAN_METHOD(VRP::New) try {
 NAN_METHOD(VRP::Solve) try {
   auto* const self = Nan::ObjectWrap::Unwrap<VRP>(info.Holder());
 
-  VRPSearchParams userParams(info);
+  if (info.Length() != 2 || !info[0]->IsObject() || !info[1]->IsFunction())
+    throw std::runtime_error{"Two arguments expected: SearchOptions (Object) or SearchConfig, and callback (Function)"};
 
-  const auto bytesChange = getBytes(userParams.routeLocks);
-  Nan::AdjustExternalMemory(bytesChange);
+  // Compiled configs get shared with the worker instead of parsed again, see vrp_search_config.h
+  const auto compiled = VRPSearchConfig::HasInstance(info[0]);
+
+  const auto userParams = compiled ? Nan::ObjectWrap::Unwrap<VRPSearchConfig>(info[0].As<v8::Object>())->searchParams()
+                                   : std::make_shared<const VRPSearchParams>(info[0].As<v8::Object>());
+
+  const auto callback = info[1].As<v8::Function>();
+
+  VRPInstance instance{self->costs,                   //
+                       self->durations,               //
+                       self->timeWindows,             //
+                       self->demands,                 //
+                       self->timeDependentDurations,  //
+                       self->resources,               //
+                       self->distances};              //
+
+  // Optional: identical solves in flight share one worker, see single_flight.h
+  const auto& coalesceKey = userParams->coalesceKey;
+
+  if (!coalesceKey.empty()) {
+    const auto same = [&instance](const VRPInstance& other) { return sameInstance(instance, other); };
+
+    if (auto flight = VRPSingleFlight::get().find(coalesceKey, same)) {
+      flight->followers.emplace_back(new Nan::Callback{callback});
+      return;
+    }
+  }
+
+  // Compiled configs account for their own memory once
+  if (!compiled) {
+    const auto bytesChange = getBytes(userParams->routeLocks);
+    Nan::AdjustExternalMemory(bytesChange);
+  }
 
   // See routing_parameters.proto and routing_enums.proto
   auto modelParams = RoutingModel::DefaultModelParameters();
@@ -68,9 +182,13 @@ NAN_METHOD(VRP::Solve) try {
   auto firstSolutionStrategy = FirstSolutionStrategy::AUTOMATIC;
   auto metaHeuristic = LocalSearchMetaheuristic::AUTOMATIC;
 
+  // A single strategy replaces the default, several of them run concurrently in the worker
+  if (userParams->firstSolutionStrategies.size() == 1)
+    firstSolutionStrategy = userParams->firstSolutionStrategies.front();
+
   searchParams.set_first_solution_strategy(firstSolutionStrategy);
   searchParams.set_local_search_metaheuristic(metaHeuristic);
-  searchParams.set_time_limit_ms(userParams.computeTimeLimit);
+  searchParams.set_time_limit_ms(userParams->computeTimeLimit);
 
   // As long as we have a homogeneous fleet wrt. costs we can simplify the underlying model
   modelParams.set_reduce_vehicle_cost_model(true);
@@ -78,27 +196,131 @@ NAN_METHOD(VRP::Solve) try {
   // Do not cache callbacks internally, too: we already provide efficient matrix adaptors
   modelParams.set_max_callback_cache_size(0);
 
-  const std::int32_t numNodes = self->costs->dim();
-  const std::int32_t numVehicles = userParams.numVehicles;
-
-  // TODO: this is getting out of hand, clean up, e.g. split into data vs. config
-  auto* worker = new VRPWorker{self->costs,                            //
-                               self->durations,                        //
-                               self->timeWindows,                      //
-                               self->demands,                          //
-                               new Nan::Callback{userParams.callback}, //
-                               modelParams,                            //
-                               searchParams,                           //
-                               numNodes,                               //
-                               numVehicles,                            //
-                               userParams.depotNode,                   //
-                               userParams.timeHorizon,                 //
-                               userParams.vehicleCapacities,           //
-                               std::move(userParams.routeLocks),       //
-                               std::move(userParams.pickups),          //
-                               std::move(userParams.deliveries)};      //
-
-  Nan::AsyncQueueWorker(worker);
+  auto* worker = new VRPWorker{instance, userParams, new Nan::Callback{callback}, modelParams, searchParams};
+
+  if (!coalesceKey.empty())
+    worker->flight = VRPSingleFlight::get().start(coalesceKey, std::move(instance));
+
+  queueWorker(worker, worker->scheduled);
+
+} catch (const std::exception& e) {
+  return Nan::ThrowError(e.what());
+}
+
+struct VRPGeneratorParams {
+  VRPGeneratorParams(v8::Local<v8::Value> value);
+
+  InstanceSpec spec;
+  bool compressMatrices;
+};
+
+VRPGeneratorParams::VRPGeneratorParams(v8::Local<v8::Value> value) {
+  if (!value->IsObject())
+    throw std::runtime_error{"Object argument expected: GeneratorOptions"};
+
+  auto opts = value.As<v8::Object>();
+
+  auto maybeNumNodes = Nan::Get(opts, Nan::New("numNodes").ToLocalChecked());
+  auto maybeNumVehicles = Nan::Get(opts, Nan::New("numVehicles").ToLocalChecked());
+  auto maybeLayout = Nan::Get(opts, Nan::New("layout").ToLocalChecked());
+  auto maybeWindowTightness = Nan::Get(opts, Nan::New("windowTightness").ToLocalChecked());
+  auto maybeCapacityTightness = Nan::Get(opts, Nan::New("capacityTightness").ToLocalChecked());
+  auto maybeClusters = Nan::Get(opts, Nan::New("clusters").ToLocalChecked());
+  auto maybeSeed = Nan::Get(opts, Nan::New("seed").ToLocalChecked());
+  auto maybeCompressMatrices = Nan::Get(opts, Nan::New("compressMatrices").ToLocalChecked());
+
+  auto numNodesOk = !maybeNumNodes.IsEmpty() && maybeNumNodes.ToLocalChecked()->IsNumber();
+  auto numVehiclesOk = !maybeNumVehicles.IsEmpty() && maybeNumVehicles.ToLocalChecked()->IsNumber();
+  auto layoutOk =
+      !maybeLayout.IsEmpty() && (maybeLayout.ToLocalChecked()->IsUndefined() || maybeLayout.ToLocalChecked()->IsString());
+  auto windowTightnessOk = !maybeWindowTightness.IsEmpty() && (maybeWindowTightness.ToLocalChecked()->IsUndefined() ||
+                                                               maybeWindowTightness.ToLocalChecked()->IsNumber());
+  auto capacityTightnessOk = !maybeCapacityTightness.IsEmpty() && (maybeCapacityTightness.ToLocalChecked()->IsUndefined() ||
+                                                                   maybeCapacityTightness.ToLocalChecked()->IsNumber());
+  auto clustersOk =
+      !maybeClusters.IsEmpty() && (maybeClusters.ToLocalChecked()->IsUndefined() || maybeClusters.ToLocalChecked()->IsNumber());
+  auto seedOk = !maybeSeed.IsEmpty() && (maybeSeed.ToLocalChecked()->IsUndefined() || maybeSeed.ToLocalChecked()->IsNumber());
+  auto compressMatricesOk = !maybeCompressMatrices.IsEmpty() && (maybeCompressMatrices.ToLocalChecked()->IsUndefined() ||
+                                                                 maybeCompressMatrices.ToLocalChecked()->IsBoolean());
+
+  if (!numNodesOk || !numVehiclesOk || !layoutOk || !windowTightnessOk || !capacityTightnessOk || !clustersOk || !seedOk ||
+      !compressMatricesOk)
+    throw std::runtime_error{"GeneratorOptions expects"
+                             " 'numNodes' (Number),"
+                             " 'numVehicles' (Number),"
+                             " optional 'layout' (String),"
+                             " optional 'windowTightness' (Number),"
+                             " optional 'capacityTightness' (Number),"
+                             " optional 'clusters' (Number),"
+                             " optional 'seed' (Number),"
+                             " optional 'compressMatrices' (Boolean)"};
+
+  spec.numNodes = Nan::To<std::int32_t>(maybeNumNodes.ToLocalChecked()).FromJust();
+  spec.numVehicles = Nan::To<std::int32_t>(maybeNumVehicles.ToLocalChecked()).FromJust();
+
+  if (!maybeLayout.ToLocalChecked()->IsUndefined())
+    spec.layout = makeInstanceLayoutFromName(*Nan::Utf8String(maybeLayout.ToLocalChecked()));
+
+  if (!maybeWindowTightness.ToLocalChecked()->IsUndefined())
+    spec.windowTightness = Nan::To<double>(maybeWindowTightness.ToLocalChecked()).FromJust();
+
+  if (!maybeCapacityTightness.ToLocalChecked()->IsUndefined())
+    spec.capacityTightness = Nan::To<double>(maybeCapacityTightness.ToLocalChecked()).FromJust();
+
+  if (!maybeClusters.ToLocalChecked()->IsUndefined())
+    spec.clusters = Nan::To<std::int32_t>(maybeClusters.ToLocalChecked()).FromJust();
+
+  if (!maybeSeed.ToLocalChecked()->IsUndefined())
+    spec.seed = Nan::To<std::uint32_t>(maybeSeed.ToLocalChecked()).FromJust();
+
+  compressMatrices = !maybeCompressMatrices.ToLocalChecked()->IsUndefined() &&
+                     Nan::To<bool>(maybeCompressMatrices.ToLocalChecked()).FromJust();
+}
+
+NAN_METHOD(VRP::Generate) try {
+  if (info.Length() != 1)
+    throw std::runtime_error{"Single object argument expected: GeneratorOptions"};
+
+  VRPGeneratorParams userParams{info[0]};
+
+  auto instance = InstanceGenerator{userParams.spec}.generate();
+
+  VRPData data;
+
+  data.numNodes = userParams.spec.numNodes;
+  data.costs = std::move(instance.costs);
+  data.durations = std::move(instance.durations);
+  data.timeWindows = std::move(instance.timeWindows);
+  data.demands = std::move(instance.demands);
+  data.compressMatrices = userParams.compressMatrices;
+
+  // Search options to go with the instance: all vehicles alike, starting at the depot
+  const auto numVehicles = userParams.spec.numVehicles;
+
+  auto vehicleCapacities = Nan::New<v8::Array>(numVehicles);
+  auto routeLocks = Nan::New<v8::Array>(numVehicles);
+
+  for (std::int32_t vehicle = 0; vehicle < numVehicles; ++vehicle) {
+    Nan::Set(vehicleCapacities, vehicle, Nan::New<v8::Number>(instance.vehicleCapacity));
+    Nan::Set(routeLocks, vehicle, Nan::New<v8::Array>());
+  }
+
+  auto searchOpts = Nan::New<v8::Object>();
+
+  Nan::Set(searchOpts, Nan::New("numVehicles").ToLocalChecked(), Nan::New<v8::Number>(numVehicles));
+  Nan::Set(searchOpts, Nan::New("depotNode").ToLocalChecked(), Nan::New<v8::Number>(0));
+  Nan::Set(searchOpts, Nan::New("timeHorizon").ToLocalChecked(), Nan::New<v8::Number>(instance.timeHorizon));
+  Nan::Set(searchOpts, Nan::New("vehicleCapacities").ToLocalChecked(), vehicleCapacities);
+  Nan::Set(searchOpts, Nan::New("routeLocks").ToLocalChecked(), routeLocks);
+  Nan::Set(searchOpts, Nan::New("pickups").ToLocalChecked(), Nan::New<v8::Array>());
+  Nan::Set(searchOpts, Nan::New("deliveries").ToLocalChecked(), Nan::New<v8::Array>());
+
+  auto out = Nan::New<v8::Object>();
+
+  Nan::Set(out, Nan::New("vrp").ToLocalChecked(), NewInstance(std::move(data)));
+  Nan::Set(out, Nan::New("searchOptions").ToLocalChecked(), searchOpts);
+
+  info.GetReturnValue().Set(out);
 
 } catch (const std::exception& e) {
   return Nan::ThrowError(e.what());
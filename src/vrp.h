@@ -4,24 +4,54 @@
 #include <nan.h>
 
 #include "adaptors.h"
+#include "time_dependent.h"
 #include "types.h"
 
+#include <cstdint>
 #include <memory>
 
+// User data a VRP instance owns, no matter whether it was read from JS arrays or decoded natively.
+struct VRPData {
+  std::int32_t numNodes;
+
+  CostMatrix costs;
+  DurationMatrix durations;
+  TimeWindows timeWindows;
+  DemandMatrix demands;
+
+  // Optional, empty for static durations. Durations then hold per-arc lower bounds.
+  TimeDependentDurations timeDependentDurations;
+
+  // Optional, named demands in addition to the demands above.
+  Resources resources;
+
+  // Optional, empty for measuring route lengths in costs.
+  DistanceMatrix distances;
+
+  bool compressMatrices;
+};
+
 class VRP : public Nan::ObjectWrap {
 public:
   static NAN_MODULE_INIT(Init);
 
+  // Wraps natively constructed data into a new VRP object, taking ownership of it
+  static v8::Local<v8::Object> NewInstance(VRPData data);
+
 private:
   static NAN_METHOD(New);
 
   static NAN_METHOD(Solve);
 
+  // Seeded synthetic instances straight into native storage, see generator.h
+  static NAN_METHOD(Generate);
+
   static Nan::Persistent<v8::Function>& constructor();
 
   // Wrapped Object
 
-  VRP(CostMatrix costs, DurationMatrix durations, TimeWindows timeWindows, DemandMatrix demands);
+  VRP(CostMatrix costs, DurationMatrix durations, TimeWindows timeWindows, DemandMatrix demands,
+      TimeDependentDurations timeDependentDurations, Resources resources, DistanceMatrix distances);
 
   // Non-Copyable
   VRP(const VRP&) = delete;
@@ -39,6 +69,12 @@ private:
   std::shared_ptr<const TimeWindows> timeWindows;
   // Demands at node s continuing to node t.
   std::shared_ptr<const DemandMatrix> demands;
+  // (s, t) arc travel durations depending on departure time at s, can be empty.
+  std::shared_ptr<const TimeDependentDurations> timeDependentDurations;
+  // Named demands at node s continuing to node t, each with its own capacity dimension.
+  std::shared_ptr<const Resources> resources;
+  // (s, t) arc distances for limiting route lengths, can be empty.
+  std::shared_ptr<const DistanceMatrix> distances;
 };
 
 #endif
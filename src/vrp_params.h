@@ -3,36 +3,54 @@
 
 #include <nan.h>
 
+#include <limits>
 #include <stdexcept>
+#include <string>
 
+#include "construct.h"
+#include "islands.h"
 #include "params.h"
+#include "pickup_delivery.h"
+#include "symmetry.h"
+#include "vrp.h"
 
-struct VRPSolverParams {
+struct VRPSolverParams : VRPData {
   VRPSolverParams(const Nan::FunctionCallbackInfo<v8::Value>& info);
-
-  std::int32_t numNodes;
-
-  CostMatrix costs;
-  DurationMatrix durations;
-  TimeWindows timeWindows;
-  DemandMatrix demands;
 };
 
+// Search options in native form: parsed on every Solve, or once for reuse via VRP.SearchConfig
 struct VRPSearchParams {
-  VRPSearchParams(const Nan::FunctionCallbackInfo<v8::Value>& info);
+  explicit VRPSearchParams(v8::Local<v8::Object> opts);
 
   std::int32_t computeTimeLimit;
   std::int32_t numVehicles;
   std::int32_t depotNode;
   std::int32_t timeHorizon;
   std::vector<int64> vehicleCapacities;
+  ResourceCapacities resourceCapacities;
 
   RouteLocks routeLocks;
 
   Pickups pickups;
   Deliveries deliveries;
-
-  v8::Local<v8::Function> callback;
+  PickupDeliveryPolicy pickupDeliveryPolicy;
+  bool contractLocks;
+  std::int32_t reloads;
+  AllowedVehicles allowedVehicles;
+  SoftTimeWindows softTimeWindows;
+  VehicleShifts vehicleShifts;
+  std::vector<int64> maxRouteLengths;
+  SearchEngine engine;
+  std::vector<FirstSolutionStrategy::Value> firstSolutionStrategies;
+  IslandPolicy islandPolicy;
+
+  // Empty unless coalescing: the search options as JSON, see single_flight.h
+  std::string coalesceKey;
+
+  std::string tenant;
+  std::int32_t cpuTimeLimit;
+  std::vector<std::vector<NodeIndex>> initialRoutes;
+  SymmetryBreaking symmetryBreaking;
 };
 
 // Caches user provided 2d Array of [Number, Number] into Vectors of Intervals
@@ -110,9 +128,163 @@ inline auto makeRouteLocksFrom2dArray(std::int32_t n, v8::Local<v8::Array> array
   return routeLocks;
 }
 
+// Caches user provided Array of [start, stop, earlyPenalty, latePenalty] (or null for none) per node into SoftTimeWindows
+inline auto makeSoftTimeWindowsFromArray(v8::Local<v8::Array> array) {
+  const auto n = static_cast<std::int32_t>(array->Length());
+
+  SoftTimeWindows softTimeWindows(n);
+
+  for (std::int32_t atIdx = 0; atIdx < n; ++atIdx) {
+    auto inner = Nan::Get(array, atIdx).ToLocalChecked();
+
+    if (inner->IsNull() || inner->IsUndefined())
+      continue;
+
+    if (!inner->IsArray() || inner.As<v8::Array>()->Length() != 4)
+      throw std::runtime_error{"Expected soft time window Array of shape [start, stop, earlyPenalty, latePenalty] or null"};
+
+    auto values = makeInt64VectorFromJsNumberArray<std::vector<int64>>(inner.As<v8::Array>());
+
+    const auto windowOk = values[0] >= 0 && values[0] <= values[1] && values[2] >= 0 && values[3] >= 0;
+
+    if (!windowOk)
+      throw std::runtime_error{"Expected soft time window start <= stop and non-negative values"};
+
+    auto& window = softTimeWindows.at(atIdx);
+
+    window.start = values[0];
+    window.stop = values[1];
+    window.earlyPenalty = values[2];
+    window.latePenalty = values[3];
+  }
+
+  return softTimeWindows;
+}
+
+// Caches user provided Array of vehicle index Arrays (or null for any vehicle) per node into AllowedVehicles
+inline auto makeAllowedVehiclesFromArray(v8::Local<v8::Array> array) {
+  AllowedVehicles allowedVehicles;
+
+  for (std::int32_t atIdx = 0; atIdx < static_cast<std::int32_t>(array->Length()); ++atIdx) {
+    auto inner = Nan::Get(array, atIdx).ToLocalChecked();
+
+    if (inner->IsNull() || inner->IsUndefined()) {
+      allowedVehicles.append({});
+      continue;
+    }
+
+    if (!inner->IsArray())
+      throw std::runtime_error{"Expected allowed vehicles of type Array or null"};
+
+    auto innerArray = inner.As<v8::Array>();
+
+    if (innerArray->Length() == 0)
+      throw std::runtime_error{"Expected at least one allowed vehicle per node, use null for any vehicle"};
+
+    allowedVehicles.append(makeInt64VectorFromJsNumberArray<std::vector<int64>>(innerArray));
+  }
+
+  return allowedVehicles;
+}
+
+// Caches user provided {departures, matrices, interpolation} Object into TimeDependentDurations
+inline auto makeTimeDependentDurationsFromObject(std::int32_t n, v8::Local<v8::Object> opts) {
+  auto maybeDepartures = Nan::Get(opts, Nan::New("departures").ToLocalChecked());
+  auto maybeMatrices = Nan::Get(opts, Nan::New("matrices").ToLocalChecked());
+  auto maybeInterpolation = Nan::Get(opts, Nan::New("interpolation").ToLocalChecked());
+
+  auto departuresOk = !maybeDepartures.IsEmpty() && maybeDepartures.ToLocalChecked()->IsArray();
+  auto matricesOk = !maybeMatrices.IsEmpty() && maybeMatrices.ToLocalChecked()->IsArray();
+  auto interpolationOk = !maybeInterpolation.IsEmpty() &&
+                         (maybeInterpolation.ToLocalChecked()->IsUndefined() || maybeInterpolation.ToLocalChecked()->IsString());
+
+  if (!departuresOk || !matricesOk || !interpolationOk)
+    throw std::runtime_error{"Time-dependent durations expect"
+                             " 'departures' (Array),"
+                             " 'matrices' (Array),"
+                             " optional 'interpolation' (String)"};
+
+  auto departuresArray = maybeDepartures.ToLocalChecked().As<v8::Array>();
+  auto matricesArray = maybeMatrices.ToLocalChecked().As<v8::Array>();
+
+  auto departures = makeVectorFromJsNumberArray<std::vector<std::int32_t>>(departuresArray);
+
+  std::vector<DurationMatrix> matrices;
+
+  for (std::uint32_t atIdx = 0; atIdx < matricesArray->Length(); ++atIdx) {
+    auto matrix = Nan::Get(matricesArray, atIdx).ToLocalChecked();
+
+    if (!matrix->IsArray())
+      throw std::runtime_error{"Expected Array of duration matrices"};
+
+    matrices.push_back(makeMatrixFrom2dArray<DurationMatrix>(n, matrix.As<v8::Array>()));
+  }
+
+  auto interpolation = TimeDependentDurations::Interpolation::Linear;
+
+  if (maybeInterpolation.ToLocalChecked()->IsString()) {
+    const std::string name = *Nan::Utf8String(maybeInterpolation.ToLocalChecked());
+
+    if (name == "step")
+      interpolation = TimeDependentDurations::Interpolation::Step;
+    else if (name != "linear")
+      throw std::runtime_error{"Expected interpolation of 'linear' or 'step'"};
+  }
+
+  return TimeDependentDurations{std::move(departures), std::move(matrices), interpolation};
+}
+
+// Caches user provided {name: Array, ..} Object into Resources; 1d Arrays per node, 2d Arrays per arc
+inline auto makeResourcesFromObject(std::int32_t n, v8::Local<v8::Object> object) {
+  auto names = Nan::GetOwnPropertyNames(object).ToLocalChecked();
+
+  Resources resources;
+
+  for (std::uint32_t atIdx = 0; atIdx < names->Length(); ++atIdx) {
+    auto name = Nan::Get(names, atIdx).ToLocalChecked();
+    auto demands = Nan::Get(object, name).ToLocalChecked();
+
+    if (!demands->IsArray())
+      throw std::runtime_error{"Expected resource demands of type Array"};
+
+    auto demandsArray = demands.As<v8::Array>();
+
+    if (static_cast<std::int32_t>(demandsArray->Length()) != n)
+      throw std::runtime_error{"Array dimension do not match size"};
+
+    const auto perArc = n > 0 && Nan::Get(demandsArray, 0).ToLocalChecked()->IsArray();
+
+    if (perArc)
+      resources.emplace_back(*Nan::Utf8String(name), makeMatrixFrom2dArray<DemandMatrix>(n, demandsArray));
+    else
+      resources.emplace_back(*Nan::Utf8String(name), makeVectorFromJsNumberArray<DemandVector>(demandsArray));
+  }
+
+  return resources;
+}
+
+// Caches user provided {name: Array, ..} Object into per-vehicle ResourceCapacities
+inline auto makeResourceCapacitiesFromObject(v8::Local<v8::Object> object) {
+  auto names = Nan::GetOwnPropertyNames(object).ToLocalChecked();
+
+  ResourceCapacities capacities;
+
+  for (std::uint32_t atIdx = 0; atIdx < names->Length(); ++atIdx) {
+    auto name = Nan::Get(names, atIdx).ToLocalChecked();
+    auto vehicleCapacities = Nan::Get(object, name).ToLocalChecked();
+
+    if (!vehicleCapacities->IsArray())
+      throw std::runtime_error{"Expected resource capacities of type Array"};
+
+    capacities[*Nan::Utf8String(name)] = makeInt64VectorFromJsNumberArray<std::vector<int64>>(vehicleCapacities.As<v8::Array>());
+  }
+
+  return capacities;
+}
+
 // Impl.
 
-VRPSolverParams::VRPSolverParams(const Nan::FunctionCallbackInfo<v8::Value>& info) {
+inline VRPSolverParams::VRPSolverParams(const Nan::FunctionCallbackInfo<v8::Value>& info) {
   if (info.Length() != 1 || !info[0]->IsObject())
     throw std::runtime_error{"Single object argument expected: SolverOptions"};
 
@@ -126,37 +298,67 @@ VRPSolverParams::VRPSolverParams(const Nan::FunctionCallbackInfo<v8::Value>& inf
 
   auto numNodesOk = !maybeNumNodes.IsEmpty() && maybeNumNodes.ToLocalChecked()->IsNumber();
   auto costMatrixOk = !maybeCostMatrix.IsEmpty() && maybeCostMatrix.ToLocalChecked()->IsArray();
-  auto durationMatrixOk = !maybeDurationMatrix.IsEmpty() && maybeDurationMatrix.ToLocalChecked()->IsArray();
-  auto timeWindowsVectorOk = !maybeTimeWindowsVector.IsEmpty() && maybeTimeWindowsVector.ToLocalChecked()->IsArray();
-  auto demandMatrixOk = !maybeDemandMatrix.IsEmpty() && maybeDemandMatrix.ToLocalChecked()->IsArray();
+  auto durationMatrixOk = !maybeDurationMatrix.IsEmpty() && (maybeDurationMatrix.ToLocalChecked()->IsUndefined() ||
+                                                               maybeDurationMatrix.ToLocalChecked()->IsObject());
+  auto timeWindowsVectorOk = !maybeTimeWindowsVector.IsEmpty() && (maybeTimeWindowsVector.ToLocalChecked()->IsUndefined() ||
+                                                                   maybeTimeWindowsVector.ToLocalChecked()->IsArray());
+  auto demandMatrixOk = !maybeDemandMatrix.IsEmpty() &&
+                        (maybeDemandMatrix.ToLocalChecked()->IsUndefined() || maybeDemandMatrix.ToLocalChecked()->IsArray());
 
   if (!numNodesOk || !costMatrixOk || !durationMatrixOk || !timeWindowsVectorOk || !demandMatrixOk)
     throw std::runtime_error{"SolverOptions expects"
                              " 'numNodes' (Number),"
                              " 'costs' (Array),"
-                             " 'durations' (Array),"
-                             " 'timeWindows' (Array),"
-                             " 'demands' (Array)"};
+                             " optional 'durations' (Array or Object),"
+                             " optional 'timeWindows' (Array),"
+                             " optional 'demands' (Array)"};
 
   numNodes = Nan::To<std::int32_t>(maybeNumNodes.ToLocalChecked()).FromJust();
 
   auto costMatrix = maybeCostMatrix.ToLocalChecked().As<v8::Array>();
-  auto durationMatrix = maybeDurationMatrix.ToLocalChecked().As<v8::Array>();
-  auto timeWindowsVector = maybeTimeWindowsVector.ToLocalChecked().As<v8::Array>();
-  auto demandMatrix = maybeDemandMatrix.ToLocalChecked().As<v8::Array>();
 
   costs = makeMatrixFrom2dArray<CostMatrix>(numNodes, costMatrix);
-  durations = makeMatrixFrom2dArray<DurationMatrix>(numNodes, durationMatrix);
-  timeWindows = makeTimeWindowsFrom2dArray(numNodes, timeWindowsVector);
-  demands = makeMatrixFrom2dArray<DemandMatrix>(numNodes, demandMatrix);
-}
 
-VRPSearchParams::VRPSearchParams(const Nan::FunctionCallbackInfo<v8::Value>& info) {
-  if (info.Length() != 2 || !info[0]->IsObject() || !info[1]->IsFunction())
-    throw std::runtime_error{"Two arguments expected: SearchOptions (Object) and callback (Function)"};
+  // Left out durations, time windows or demands stay empty: the worker then skips their dimensions
 
-  auto opts = info[0].As<v8::Object>();
+  // Either a static matrix or matrices per departure time; the dimension then uses per-arc lower bounds
+  if (maybeDurationMatrix.ToLocalChecked()->IsArray()) {
+    durations = makeMatrixFrom2dArray<DurationMatrix>(numNodes, maybeDurationMatrix.ToLocalChecked().As<v8::Array>());
+  } else if (maybeDurationMatrix.ToLocalChecked()->IsObject()) {
+    timeDependentDurations = makeTimeDependentDurationsFromObject(numNodes, maybeDurationMatrix.ToLocalChecked().As<v8::Object>());
+    durations = timeDependentDurations.makeLowerBounds();
+  }
+
+  if (maybeTimeWindowsVector.ToLocalChecked()->IsArray())
+    timeWindows = makeTimeWindowsFrom2dArray(numNodes, maybeTimeWindowsVector.ToLocalChecked().As<v8::Array>());
+
+  if (maybeDemandMatrix.ToLocalChecked()->IsArray())
+    demands = makeMatrixFrom2dArray<DemandMatrix>(numNodes, maybeDemandMatrix.ToLocalChecked().As<v8::Array>());
+
+  compressMatrices = makeCompressMatricesFromOptions(opts);
+
+  // Optional: additional named demands, each getting its own capacity dimension
+  auto maybeResources = Nan::Get(opts, Nan::New("resources").ToLocalChecked());
+
+  if (!maybeResources.IsEmpty() && !maybeResources.ToLocalChecked()->IsUndefined()) {
+    if (!maybeResources.ToLocalChecked()->IsObject())
+      throw std::runtime_error{"SolverOptions expects 'resources' (Object)"};
 
+    resources = makeResourcesFromObject(numNodes, maybeResources.ToLocalChecked().As<v8::Object>());
+  }
+
+  // Optional: distances for route length limits when costs are not distances already
+  auto maybeDistanceMatrix = Nan::Get(opts, Nan::New("distances").ToLocalChecked());
+
+  if (!maybeDistanceMatrix.IsEmpty() && !maybeDistanceMatrix.ToLocalChecked()->IsUndefined()) {
+    if (!maybeDistanceMatrix.ToLocalChecked()->IsArray())
+      throw std::runtime_error{"SolverOptions expects 'distances' (Array)"};
+
+    distances = makeMatrixFrom2dArray<DistanceMatrix>(numNodes, maybeDistanceMatrix.ToLocalChecked().As<v8::Array>());
+  }
+}
+
+inline VRPSearchParams::VRPSearchParams(v8::Local<v8::Object> opts) {
   auto maybeComputeTimeLimit = Nan::Get(opts, Nan::New("computeTimeLimit").ToLocalChecked());
   auto maybeNumVehicles = Nan::Get(opts, Nan::New("numVehicles").ToLocalChecked());
   auto maybeDepotNode = Nan::Get(opts, Nan::New("depotNode").ToLocalChecked());
@@ -169,8 +371,10 @@ VRPSearchParams::VRPSearchParams(const Nan::FunctionCallbackInfo<v8::Value>& inf
   auto computeTimeLimitOk = !maybeComputeTimeLimit.IsEmpty() && maybeComputeTimeLimit.ToLocalChecked()->IsNumber();
   auto numVehiclesOk = !maybeNumVehicles.IsEmpty() && maybeNumVehicles.ToLocalChecked()->IsNumber();
   auto depotNodeOk = !maybeDepotNode.IsEmpty() && maybeDepotNode.ToLocalChecked()->IsNumber();
-  auto timeHorizonOk = !maybeTimeHorizon.IsEmpty() && maybeTimeHorizon.ToLocalChecked()->IsNumber();
-  auto vehicleCapacitiesOk = !maybeVehicleCapacities.IsEmpty() && maybeVehicleCapacities.ToLocalChecked()->IsArray();  // IsNumber() changed to IsArray()
+  auto timeHorizonOk = !maybeTimeHorizon.IsEmpty() &&
+                       (maybeTimeHorizon.ToLocalChecked()->IsUndefined() || maybeTimeHorizon.ToLocalChecked()->IsNumber());
+  auto vehicleCapacitiesOk = !maybeVehicleCapacities.IsEmpty() && (maybeVehicleCapacities.ToLocalChecked()->IsUndefined() ||
+                                                                   maybeVehicleCapacities.ToLocalChecked()->IsArray());
   auto routeLocksOk = !maybeRouteLocks.IsEmpty() && maybeRouteLocks.ToLocalChecked()->IsArray();
   auto pickupsOk = !maybePickups.IsEmpty() && maybePickups.ToLocalChecked()->IsArray();
   auto deliveriesOk = !maybeDeliveries.IsEmpty() && maybeDeliveries.ToLocalChecked()->IsArray();
@@ -182,8 +386,8 @@ VRPSearchParams::VRPSearchParams(const Nan::FunctionCallbackInfo<v8::Value>& inf
                              " 'computeTimeLimit' (Number),"
                              " 'numVehicles' (Number),"
                              " 'depotNode' (Number),"
-                             " 'timeHorizon' (Number),"
-                             " 'vehicleCapacities' (Array),"
+                             " optional 'timeHorizon' (Number),"
+                             " optional 'vehicleCapacities' (Array),"
                              " 'routeLocks' (Array),"
                              " 'pickups' (Array),"
                              " 'deliveries' (Array)"};
@@ -191,7 +395,12 @@ VRPSearchParams::VRPSearchParams(const Nan::FunctionCallbackInfo<v8::Value>& inf
   computeTimeLimit = Nan::To<std::int32_t>(maybeComputeTimeLimit.ToLocalChecked()).FromJust();
   numVehicles = Nan::To<std::int32_t>(maybeNumVehicles.ToLocalChecked()).FromJust();
   depotNode = Nan::To<std::int32_t>(maybeDepotNode.ToLocalChecked()).FromJust();
-  timeHorizon = Nan::To<std::int32_t>(maybeTimeHorizon.ToLocalChecked()).FromJust();
+
+  // Without a horizon routes may take as long as they need
+  timeHorizon = std::numeric_limits<std::int32_t>::max();
+
+  if (maybeTimeHorizon.ToLocalChecked()->IsNumber())
+    timeHorizon = Nan::To<std::int32_t>(maybeTimeHorizon.ToLocalChecked()).FromJust();
 
   auto routeLocksArray = maybeRouteLocks.ToLocalChecked().As<v8::Array>();
   routeLocks = makeRouteLocksFrom2dArray(numVehicles, routeLocksArray);
@@ -202,10 +411,254 @@ VRPSearchParams::VRPSearchParams(const Nan::FunctionCallbackInfo<v8::Value>& inf
   auto deliveriesArray = maybeDeliveries.ToLocalChecked().As<v8::Array>();
   deliveries = makeVectorFromJsNumberArray<Deliveries>(deliveriesArray);
 
-  auto vehicleCapacitiesArray = maybeVehicleCapacities.ToLocalChecked().As<v8::Array>();
-  vehicleCapacities = makeInt64VectorFromJsNumberArray<std::vector<int64> >(vehicleCapacitiesArray);
+  // Only needed for demands, see VRPWorker
+  if (maybeVehicleCapacities.ToLocalChecked()->IsArray()) {
+    auto vehicleCapacitiesArray = maybeVehicleCapacities.ToLocalChecked().As<v8::Array>();
+    vehicleCapacities = makeInt64VectorFromJsNumberArray<std::vector<int64> >(vehicleCapacitiesArray);
+  }
+
+  // Optional: capacities for the resources given to the constructor
+  auto maybeResourceCapacities = Nan::Get(opts, Nan::New("resourceCapacities").ToLocalChecked());
+
+  if (!maybeResourceCapacities.IsEmpty() && !maybeResourceCapacities.ToLocalChecked()->IsUndefined()) {
+    if (!maybeResourceCapacities.ToLocalChecked()->IsObject())
+      throw std::runtime_error{"SearchOptions expects 'resourceCapacities' (Object)"};
 
-  callback = info[1].As<v8::Function>();
+    resourceCapacities = makeResourceCapacitiesFromObject(maybeResourceCapacities.ToLocalChecked().As<v8::Object>());
+  }
+
+  // Optional: how pickup and delivery pairs get enforced, see pickup_delivery.h
+  auto maybePickupDeliveryMode = Nan::Get(opts, Nan::New("pickupDeliveryMode").ToLocalChecked());
+
+  if (!maybePickupDeliveryMode.IsEmpty() && !maybePickupDeliveryMode.ToLocalChecked()->IsUndefined()) {
+    if (!maybePickupDeliveryMode.ToLocalChecked()->IsString())
+      throw std::runtime_error{"SearchOptions expects 'pickupDeliveryMode' (String)"};
+
+    pickupDeliveryPolicy.mode = makePickupDeliveryModeFromName(*Nan::Utf8String(maybePickupDeliveryMode.ToLocalChecked()));
+  }
+
+  auto maybePickupDeliveryOrder = Nan::Get(opts, Nan::New("pickupDeliveryOrder").ToLocalChecked());
+
+  if (!maybePickupDeliveryOrder.IsEmpty() && !maybePickupDeliveryOrder.ToLocalChecked()->IsUndefined()) {
+    if (!maybePickupDeliveryOrder.ToLocalChecked()->IsString())
+      throw std::runtime_error{"SearchOptions expects 'pickupDeliveryOrder' (String)"};
+
+    pickupDeliveryPolicy.order = makePickupDeliveryOrderFromName(*Nan::Utf8String(maybePickupDeliveryOrder.ToLocalChecked()));
+  }
+
+  // Optional: which search solves the problem, see construct.h
+  auto maybeEngine = Nan::Get(opts, Nan::New("engine").ToLocalChecked());
+
+  engine = SearchEngine::Routing;
+
+  if (!maybeEngine.IsEmpty() && !maybeEngine.ToLocalChecked()->IsUndefined()) {
+    if (!maybeEngine.ToLocalChecked()->IsString())
+      throw std::runtime_error{"SearchOptions expects 'engine' (String)"};
+
+    engine = makeSearchEngineFromName(*Nan::Utf8String(maybeEngine.ToLocalChecked()));
+  }
+
+  // Optional: pruning solutions which only relabel identical vehicles, see symmetry.h
+  auto maybeSymmetryBreaking = Nan::Get(opts, Nan::New("symmetryBreaking").ToLocalChecked());
+
+  symmetryBreaking = SymmetryBreaking::None;
+
+  if (!maybeSymmetryBreaking.IsEmpty() && !maybeSymmetryBreaking.ToLocalChecked()->IsUndefined()) {
+    if (!maybeSymmetryBreaking.ToLocalChecked()->IsString())
+      throw std::runtime_error{"SearchOptions expects 'symmetryBreaking' (String)"};
+
+    symmetryBreaking = makeSymmetryBreakingFromName(*Nan::Utf8String(maybeSymmetryBreaking.ToLocalChecked()));
+  }
+
+  // Optional: first solution strategies by name as in routing_enums.proto, several of them run concurrently
+  auto maybeFirstSolutionStrategies = Nan::Get(opts, Nan::New("firstSolutionStrategies").ToLocalChecked());
+
+  if (!maybeFirstSolutionStrategies.IsEmpty() && !maybeFirstSolutionStrategies.ToLocalChecked()->IsUndefined()) {
+    if (!maybeFirstSolutionStrategies.ToLocalChecked()->IsArray())
+      throw std::runtime_error{"SearchOptions expects 'firstSolutionStrategies' (Array)"};
+
+    auto strategiesArray = maybeFirstSolutionStrategies.ToLocalChecked().As<v8::Array>();
+
+    for (std::uint32_t atIdx = 0; atIdx < strategiesArray->Length(); ++atIdx) {
+      auto name = Nan::Get(strategiesArray, atIdx).ToLocalChecked();
+
+      FirstSolutionStrategy::Value strategy;
+
+      if (!name->IsString() || !FirstSolutionStrategy::Value_Parse(*Nan::Utf8String(name), &strategy))
+        throw std::runtime_error{"Expected first solution strategy names such as 'PATH_CHEAPEST_ARC' or 'SAVINGS'"};
+
+      firstSolutionStrategies.push_back(strategy);
+    }
+  }
+
+  // Optional: cooperative searches sharing their solutions, see islands.h
+  auto maybeIslands = Nan::Get(opts, Nan::New("islands").ToLocalChecked());
+
+  if (!maybeIslands.IsEmpty() && !maybeIslands.ToLocalChecked()->IsUndefined()) {
+    if (!maybeIslands.ToLocalChecked()->IsNumber())
+      throw std::runtime_error{"SearchOptions expects 'islands' (Number)"};
+
+    islandPolicy.islands = Nan::To<std::int32_t>(maybeIslands.ToLocalChecked()).FromJust();
+  }
+
+  auto maybeIslandSyncInterval = Nan::Get(opts, Nan::New("islandSyncInterval").ToLocalChecked());
+
+  if (!maybeIslandSyncInterval.IsEmpty() && !maybeIslandSyncInterval.ToLocalChecked()->IsUndefined()) {
+    if (!maybeIslandSyncInterval.ToLocalChecked()->IsNumber())
+      throw std::runtime_error{"SearchOptions expects 'islandSyncInterval' (Number)"};
+
+    islandPolicy.syncInterval = Nan::To<std::int32_t>(maybeIslandSyncInterval.ToLocalChecked()).FromJust();
+  }
+
+  // Optional: solve with locked chains contracted into single nodes, see reduction.h
+  auto maybeContractLocks = Nan::Get(opts, Nan::New("contractLocks").ToLocalChecked());
+
+  contractLocks = false;
+
+  if (!maybeContractLocks.IsEmpty() && !maybeContractLocks.ToLocalChecked()->IsUndefined()) {
+    if (!maybeContractLocks.ToLocalChecked()->IsBoolean())
+      throw std::runtime_error{"SearchOptions expects 'contractLocks' (Boolean)"};
+
+    contractLocks = Nan::To<bool>(maybeContractLocks.ToLocalChecked()).FromJust();
+  }
+
+  // Optional: depot reload stops shared by the fleet, emptying vehicles for another trip
+  auto maybeReloads = Nan::Get(opts, Nan::New("reloads").ToLocalChecked());
+
+  reloads = 0;
+
+  if (!maybeReloads.IsEmpty() && !maybeReloads.ToLocalChecked()->IsUndefined()) {
+    if (!maybeReloads.ToLocalChecked()->IsNumber())
+      throw std::runtime_error{"SearchOptions expects 'reloads' (Number)"};
+
+    reloads = Nan::To<std::int32_t>(maybeReloads.ToLocalChecked()).FromJust();
+  }
+
+  // Optional: vehicles allowed per node, see AllowedVehicles
+  auto maybeAllowedVehicles = Nan::Get(opts, Nan::New("allowedVehicles").ToLocalChecked());
+
+  if (!maybeAllowedVehicles.IsEmpty() && !maybeAllowedVehicles.ToLocalChecked()->IsUndefined()) {
+    if (!maybeAllowedVehicles.ToLocalChecked()->IsArray())
+      throw std::runtime_error{"SearchOptions expects 'allowedVehicles' (Array)"};
+
+    allowedVehicles = makeAllowedVehiclesFromArray(maybeAllowedVehicles.ToLocalChecked().As<v8::Array>());
+  }
+
+  // Optional: soft time windows per node, on top of the hard ones
+  auto maybeSoftTimeWindows = Nan::Get(opts, Nan::New("softTimeWindows").ToLocalChecked());
+
+  if (!maybeSoftTimeWindows.IsEmpty() && !maybeSoftTimeWindows.ToLocalChecked()->IsUndefined()) {
+    if (!maybeSoftTimeWindows.ToLocalChecked()->IsArray())
+      throw std::runtime_error{"SearchOptions expects 'softTimeWindows' (Array)"};
+
+    softTimeWindows = makeSoftTimeWindowsFromArray(maybeSoftTimeWindows.ToLocalChecked().As<v8::Array>());
+  }
+
+  // Optional: per-vehicle shifts, route duration limit and span cost, see VehicleShifts
+  auto maybeVehicleShifts = Nan::Get(opts, Nan::New("vehicleShifts").ToLocalChecked());
+
+  if (!maybeVehicleShifts.IsEmpty() && !maybeVehicleShifts.ToLocalChecked()->IsUndefined()) {
+    if (!maybeVehicleShifts.ToLocalChecked()->IsArray())
+      throw std::runtime_error{"SearchOptions expects 'vehicleShifts' (Array)"};
+
+    auto vehicleShiftsArray = maybeVehicleShifts.ToLocalChecked().As<v8::Array>();
+
+    for (std::int32_t atIdx = 0; atIdx < static_cast<std::int32_t>(vehicleShiftsArray->Length()); ++atIdx) {
+      auto shift = Nan::Get(vehicleShiftsArray, atIdx).ToLocalChecked();
+
+      if (shift->IsNull() || shift->IsUndefined()) {
+        vehicleShifts.windows.push_back(Interval{0, timeHorizon});
+        continue;
+      }
+
+      if (!shift->IsArray() || shift.As<v8::Array>()->Length() != 2)
+        throw std::runtime_error{"Expected vehicle shift Array of shape [start, stop] or null"};
+
+      auto bounds = makeInt64VectorFromJsNumberArray<std::vector<int64>>(shift.As<v8::Array>());
+
+      vehicleShifts.windows.push_back(Interval{static_cast<std::int32_t>(bounds[0]), static_cast<std::int32_t>(bounds[1])});
+    }
+  }
+
+  auto maybeMaxRouteDuration = Nan::Get(opts, Nan::New("maxRouteDuration").ToLocalChecked());
+
+  if (!maybeMaxRouteDuration.IsEmpty() && !maybeMaxRouteDuration.ToLocalChecked()->IsUndefined()) {
+    if (!maybeMaxRouteDuration.ToLocalChecked()->IsNumber())
+      throw std::runtime_error{"SearchOptions expects 'maxRouteDuration' (Number)"};
+
+    vehicleShifts.maxRouteDuration = Nan::To<std::int32_t>(maybeMaxRouteDuration.ToLocalChecked()).FromJust();
+  }
+
+  auto maybeSpanCost = Nan::Get(opts, Nan::New("spanCost").ToLocalChecked());
+
+  if (!maybeSpanCost.IsEmpty() && !maybeSpanCost.ToLocalChecked()->IsUndefined()) {
+    if (!maybeSpanCost.ToLocalChecked()->IsNumber())
+      throw std::runtime_error{"SearchOptions expects 'spanCost' (Number)"};
+
+    vehicleShifts.spanCost = Nan::To<std::int32_t>(maybeSpanCost.ToLocalChecked()).FromJust();
+  }
+
+  // Optional: per-vehicle limits on route lengths in distances, or costs without distances
+  auto maybeMaxRouteLengths = Nan::Get(opts, Nan::New("maxRouteLengths").ToLocalChecked());
+
+  if (!maybeMaxRouteLengths.IsEmpty() && !maybeMaxRouteLengths.ToLocalChecked()->IsUndefined()) {
+    if (!maybeMaxRouteLengths.ToLocalChecked()->IsArray())
+      throw std::runtime_error{"SearchOptions expects 'maxRouteLengths' (Array)"};
+
+    auto maxRouteLengthsArray = maybeMaxRouteLengths.ToLocalChecked().As<v8::Array>();
+    maxRouteLengths = makeInt64VectorFromJsNumberArray<std::vector<int64>>(maxRouteLengthsArray);
+  }
+
+  // Optional: identical solves in flight share one worker; options are identical if their JSON is
+  auto maybeCoalesce = Nan::Get(opts, Nan::New("coalesce").ToLocalChecked());
+
+  if (!maybeCoalesce.IsEmpty() && !maybeCoalesce.ToLocalChecked()->IsUndefined()) {
+    if (!maybeCoalesce.ToLocalChecked()->IsBoolean())
+      throw std::runtime_error{"SearchOptions expects 'coalesce' (Boolean)"};
+
+    if (Nan::To<bool>(maybeCoalesce.ToLocalChecked()).FromJust()) {
+      Nan::JSON json;
+      auto maybeJson = json.Stringify(opts);
+
+      if (maybeJson.IsEmpty())
+        throw std::runtime_error{"Expected SearchOptions serializable to JSON for 'coalesce'"};
+
+      coalesceKey = *Nan::Utf8String{maybeJson.ToLocalChecked()};
+    }
+  }
+
+  // Optional: milliseconds of CPU time to search for, computeTimeLimit stays a limit on wall time
+  auto maybeCpuTimeLimit = Nan::Get(opts, Nan::New("cpuTimeLimit").ToLocalChecked());
+
+  cpuTimeLimit = 0;
+
+  if (!maybeCpuTimeLimit.IsEmpty() && !maybeCpuTimeLimit.ToLocalChecked()->IsUndefined()) {
+    if (!maybeCpuTimeLimit.ToLocalChecked()->IsNumber())
+      throw std::runtime_error{"SearchOptions expects 'cpuTimeLimit' (Number)"};
+
+    cpuTimeLimit = Nan::To<std::int32_t>(maybeCpuTimeLimit.ToLocalChecked()).FromJust();
+  }
+
+  // Optional: per vehicle the nodes of a solution to start searching from
+  auto maybeInitialRoutes = Nan::Get(opts, Nan::New("initialRoutes").ToLocalChecked());
+
+  if (!maybeInitialRoutes.IsEmpty() && !maybeInitialRoutes.ToLocalChecked()->IsUndefined()) {
+    if (!maybeInitialRoutes.ToLocalChecked()->IsArray())
+      throw std::runtime_error{"SearchOptions expects 'initialRoutes' (Array)"};
+
+    auto initialRoutesArray = maybeInitialRoutes.ToLocalChecked().As<v8::Array>();
+    initialRoutes = makeRouteLocksFrom2dArray(numVehicles, initialRoutesArray);
+  }
+
+  // Optional: tenant sharing the scheduler's cores with others, see configureScheduler
+  auto maybeTenant = Nan::Get(opts, Nan::New("tenant").ToLocalChecked());
+
+  if (!maybeTenant.IsEmpty() && !maybeTenant.ToLocalChecked()->IsUndefined()) {
+    if (!maybeTenant.ToLocalChecked()->IsString())
+      throw std::runtime_error{"SearchOptions expects 'tenant' (String)"};
+
+    tenant = *Nan::Utf8String{maybeTenant.ToLocalChecked()};
+  }
 }
 
 #endif
@@ -0,0 +1,62 @@
+#include "vrp_search_config.h"
+
+#include <utility>
+#include <vector>
+
+NAN_MODULE_INIT(VRPSearchConfig::Init) {
+  const auto whoami = Nan::New("SearchConfig").ToLocalChecked();
+
+  auto fnTp = Nan::New<v8::FunctionTemplate>(New);
+  fnTp->SetClassName(whoami);
+  fnTp->InstanceTemplate()->SetInternalFieldCount(1);
+
+  constructorTemplate().Reset(fnTp);
+
+  const auto fn = Nan::GetFunction(fnTp).ToLocalChecked();
+  constructor().Reset(fn);
+
+  Nan::Set(target, whoami, fn);
+}
+
+bool VRPSearchConfig::HasInstance(v8::Local<v8::Value> value) { return Nan::New(constructorTemplate())->HasInstance(value); }
+
+NAN_METHOD(VRPSearchConfig::New) try {
+  // Handle `new T()` as well as `T()`, passing on the arguments
+  if (!info.IsConstructCall()) {
+    std::vector<v8::Local<v8::Value>> argv;
+
+    for (auto atIdx = 0; atIdx < info.Length(); ++atIdx)
+      argv.push_back(info[atIdx]);
+
+    auto init = Nan::New(constructor());
+    info.GetReturnValue().Set(Nan::NewInstance(init, static_cast<int>(argv.size()), argv.data()).ToLocalChecked());
+    return;
+  }
+
+  if (info.Length() != 1 || !info[0]->IsObject())
+    throw std::runtime_error{"Single object argument expected: SearchOptions"};
+
+  auto userParams = std::make_shared<const VRPSearchParams>(info[0].As<v8::Object>());
+
+  const auto bytesChange = getBytes(userParams->routeLocks);
+  Nan::AdjustExternalMemory(bytesChange);
+
+  auto* self = new VRPSearchConfig{std::move(userParams)};
+
+  self->Wrap(info.This());
+
+  info.GetReturnValue().Set(info.This());
+
+} catch (const std::exception& e) {
+  return Nan::ThrowError(e.what());
+}
+
+Nan::Persistent<v8::Function>& VRPSearchConfig::constructor() {
+  static Nan::Persistent<v8::Function> init;
+  return init;
+}
+
+Nan::Persistent<v8::FunctionTemplate>& VRPSearchConfig::constructorTemplate() {
+  static Nan::Persistent<v8::FunctionTemplate> init;
+  return init;
+}
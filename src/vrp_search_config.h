@@ -0,0 +1,33 @@
+#ifndef NODE_OR_TOOLS_VRP_SEARCH_CONFIG_8A4D2F6B1C93_H
+#define NODE_OR_TOOLS_VRP_SEARCH_CONFIG_8A4D2F6B1C93_H
+
+#include <nan.h>
+
+#include "vrp_params.h"
+
+#include <memory>
+
+// Search options validated and converted to native form once: new VRP.SearchConfig(opts).
+// Solve takes the config in place of the options object, sharing the native options instead of parsing them again.
+class VRPSearchConfig : public Nan::ObjectWrap {
+public:
+  static NAN_MODULE_INIT(Init);
+
+  static bool HasInstance(v8::Local<v8::Value> value);
+
+  const std::shared_ptr<const VRPSearchParams>& searchParams() const { return params; }
+
+private:
+  static NAN_METHOD(New);
+
+  static Nan::Persistent<v8::Function>& constructor();
+  static Nan::Persistent<v8::FunctionTemplate>& constructorTemplate();
+
+  // Wrapped Object
+
+  explicit VRPSearchConfig(std::shared_ptr<const VRPSearchParams> params_) : params{std::move(params_)} {}
+
+  const std::shared_ptr<const VRPSearchParams> params;
+};
+
+#endif
@@ -0,0 +1,273 @@
+#include "vrp_stream.h"
+#include "vrp.h"
+
+#include <cerrno>
+#include <cstring>
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+struct VRPStreamParams {
+  VRPStreamParams(v8::Local<v8::Value> value);
+
+  std::int32_t numNodes;
+  StreamLayout layout;
+  bool compressMatrices;
+
+  v8::Local<v8::Value> onProgress;
+};
+
+VRPStreamParams::VRPStreamParams(v8::Local<v8::Value> value) {
+  if (!value->IsObject())
+    throw std::runtime_error{"Object argument expected: StreamOptions"};
+
+  auto opts = value.As<v8::Object>();
+
+  auto maybeNumNodes = Nan::Get(opts, Nan::New("numNodes").ToLocalChecked());
+  auto maybeLayout = Nan::Get(opts, Nan::New("layout").ToLocalChecked());
+  auto maybeCompressMatrices = Nan::Get(opts, Nan::New("compressMatrices").ToLocalChecked());
+  auto maybeOnProgress = Nan::Get(opts, Nan::New("onProgress").ToLocalChecked());
+
+  auto numNodesOk = !maybeNumNodes.IsEmpty() && maybeNumNodes.ToLocalChecked()->IsNumber();
+  auto layoutOk = !maybeLayout.IsEmpty() && (maybeLayout.ToLocalChecked()->IsUndefined() || maybeLayout.ToLocalChecked()->IsArray());
+  auto compressMatricesOk = !maybeCompressMatrices.IsEmpty() && (maybeCompressMatrices.ToLocalChecked()->IsUndefined() ||
+                                                                 maybeCompressMatrices.ToLocalChecked()->IsBoolean());
+  auto onProgressOk =
+      !maybeOnProgress.IsEmpty() && (maybeOnProgress.ToLocalChecked()->IsUndefined() || maybeOnProgress.ToLocalChecked()->IsFunction());
+
+  if (!numNodesOk || !layoutOk || !compressMatricesOk || !onProgressOk)
+    throw std::runtime_error{"StreamOptions expects"
+                             " 'numNodes' (Number),"
+                             " optional 'layout' (Array),"
+                             " optional 'compressMatrices' (Boolean),"
+                             " optional 'onProgress' (Function)"};
+
+  numNodes = Nan::To<std::int32_t>(maybeNumNodes.ToLocalChecked()).FromJust();
+
+  if (numNodes < 0)
+    throw std::runtime_error{"Negative dimension"};
+
+  if (maybeLayout.ToLocalChecked()->IsUndefined()) {
+    layout = makeDefaultStreamLayout();
+  } else {
+    auto layoutArray = maybeLayout.ToLocalChecked().As<v8::Array>();
+
+    for (std::uint32_t atIdx = 0; atIdx < layoutArray->Length(); ++atIdx) {
+      auto name = Nan::Get(layoutArray, atIdx).ToLocalChecked();
+
+      if (!name->IsString())
+        throw std::runtime_error{"Expected layout section of type String"};
+
+      layout.push_back(makeStreamSectionFromName(*Nan::Utf8String(name)));
+    }
+  }
+
+  compressMatrices = Nan::To<bool>(maybeCompressMatrices.ToLocalChecked()).FromJust();
+  onProgress = maybeOnProgress.ToLocalChecked();
+}
+
+// Moves the decoded storage over to a new VRP object
+static v8::Local<v8::Object> makeVRPFromDecoder(StreamDecoder& decoder, bool compressMatrices) {
+  VRPData data;
+
+  data.numNodes = decoder.numNodes;
+  data.costs = std::move(decoder.costs);
+  data.durations = std::move(decoder.durations);
+  data.timeWindows = std::move(decoder.timeWindows);
+  data.demands = std::move(decoder.demands);
+  data.compressMatrices = compressMatrices;
+
+  return VRP::NewInstance(std::move(data));
+}
+
+struct VRPFdWorker final : Nan::AsyncProgressWorker {
+  using Base = Nan::AsyncProgressWorker;
+
+  VRPFdWorker(int fd_, std::unique_ptr<StreamDecoder> decoder_, bool compressMatrices_, Nan::Callback* callback,
+              Nan::Callback* progress_)
+      : Base(callback), fd{fd_}, decoder{std::move(decoder_)}, compressMatrices{compressMatrices_}, progress{progress_} {}
+
+  void Execute(const ExecutionProgress& executionProgress) override {
+    const std::size_t kChunkBytes = 1 << 16;
+    std::vector<char> chunk(kChunkBytes);
+
+    try {
+      while (!decoder->done()) {
+        // Never read past the instance: the rest of the fd belongs to the caller
+        const auto left = static_cast<std::size_t>(decoder->totalBytes() - decoder->bytesDecoded());
+        const auto got = ::read(fd, chunk.data(), std::min(left, kChunkBytes));
+
+        if (got < 0 && errno == EINTR)
+          continue;
+
+        if (got < 0)
+          return SetErrorMessage(std::strerror(errno));
+
+        if (got == 0)
+          return SetErrorMessage("Unexpected end of stream");
+
+        decoder->feed(chunk.data(), got);
+
+        const auto bytesDecoded = decoder->bytesDecoded();
+        executionProgress.Send(reinterpret_cast<const char*>(&bytesDecoded), sizeof(bytesDecoded));
+      }
+    } catch (const std::exception& e) {
+      return SetErrorMessage(e.what());
+    }
+  }
+
+  void HandleProgressCallback(const char* data, std::size_t count) override {
+    Nan::HandleScope scope;
+
+    if (!progress || count != sizeof(std::int64_t))
+      return;
+
+    std::int64_t bytesDecoded;
+    std::memcpy(&bytesDecoded, data, sizeof(bytesDecoded));
+
+    const auto argc = 2u;
+    v8::Local<v8::Value> argv[argc] = {Nan::New<v8::Number>(bytesDecoded), Nan::New<v8::Number>(decoder->totalBytes())};
+
+    progress->Call(argc, argv);
+  }
+
+  void HandleOKCallback() override {
+    Nan::HandleScope scope;
+
+    v8::Local<v8::Value> vrp;
+
+    try {
+      vrp = makeVRPFromDecoder(*decoder, compressMatrices);
+    } catch (const std::exception& e) {
+      const auto argc = 1u;
+      v8::Local<v8::Value> argv[argc] = {Nan::Error(e.what())};
+      callback->Call(argc, argv);
+      return;
+    }
+
+    const auto argc = 2u;
+    v8::Local<v8::Value> argv[argc] = {Nan::Null(), vrp};
+
+    callback->Call(argc, argv);
+  }
+
+  int fd;
+  std::unique_ptr<StreamDecoder> decoder;
+  bool compressMatrices;
+
+  std::unique_ptr<Nan::Callback> progress;
+};
+
+VRPStream::VRPStream(std::unique_ptr<StreamDecoder> decoder_, bool compressMatrices_)
+    : decoder{std::move(decoder_)}, compressMatrices{compressMatrices_} {}
+
+NAN_MODULE_INIT(VRPStream::Init) {
+  const auto whoami = Nan::New("Stream").ToLocalChecked();
+
+  auto fnTp = Nan::New<v8::FunctionTemplate>(New);
+  fnTp->SetClassName(whoami);
+  fnTp->InstanceTemplate()->SetInternalFieldCount(1);
+
+  SetPrototypeMethod(fnTp, "Write", Write);
+  SetPrototypeMethod(fnTp, "End", End);
+
+  const auto fn = Nan::GetFunction(fnTp).ToLocalChecked();
+  constructor().Reset(fn);
+
+  Nan::Set(target, whoami, fn);
+}
+
+NAN_METHOD(VRPStream::FromFd) try {
+  if (info.Length() != 3 || !info[0]->IsNumber() || !info[1]->IsObject() || !info[2]->IsFunction())
+    throw std::runtime_error{"Three arguments expected: fd (Number), StreamOptions (Object) and callback (Function)"};
+
+  const auto fd = Nan::To<std::int32_t>(info[0]).FromJust();
+
+  VRPStreamParams userParams{info[1]};
+
+  auto decoder = std::make_unique<StreamDecoder>(userParams.numNodes, std::move(userParams.layout));
+
+  auto* progress = userParams.onProgress->IsFunction() ? new Nan::Callback{userParams.onProgress.As<v8::Function>()} : nullptr;
+
+  auto* worker = new VRPFdWorker{fd,                                              //
+                                 std::move(decoder),                              //
+                                 userParams.compressMatrices,                     //
+                                 new Nan::Callback{info[2].As<v8::Function>()},   //
+                                 progress};                                       //
+
+  Nan::AsyncQueueWorker(worker);
+
+} catch (const std::exception& e) {
+  return Nan::ThrowError(e.what());
+}
+
+NAN_METHOD(VRPStream::New) try {
+  if (!info.IsConstructCall())
+    throw std::runtime_error{"Stream requires construction with new"};
+
+  if (info.Length() != 1)
+    throw std::runtime_error{"Single object argument expected: StreamOptions"};
+
+  VRPStreamParams userParams{info[0]};
+
+  auto decoder = std::make_unique<StreamDecoder>(userParams.numNodes, std::move(userParams.layout));
+
+  auto* self = new VRPStream{std::move(decoder), userParams.compressMatrices};
+
+  self->Wrap(info.This());
+
+  info.GetReturnValue().Set(info.This());
+
+} catch (const std::exception& e) {
+  return Nan::ThrowError(e.what());
+}
+
+NAN_METHOD(VRPStream::Write) try {
+  auto* const self = Nan::ObjectWrap::Unwrap<VRPStream>(info.Holder());
+
+  if (info.Length() != 1 || !node::Buffer::HasInstance(info[0]))
+    throw std::runtime_error{"Single Buffer argument expected"};
+
+  if (!self->decoder)
+    throw std::runtime_error{"Stream already ended"};
+
+  const auto* bytes = node::Buffer::Data(info[0]);
+  const auto len = node::Buffer::Length(info[0]);
+
+  const auto consumed = self->decoder->feed(bytes, len);
+
+  if (consumed != len)
+    throw std::runtime_error{"Stream exceeds the size given by numNodes and layout"};
+
+  info.GetReturnValue().Set(Nan::New<v8::Number>(self->decoder->bytesDecoded()));
+
+} catch (const std::exception& e) {
+  return Nan::ThrowError(e.what());
+}
+
+NAN_METHOD(VRPStream::End) try {
+  auto* const self = Nan::ObjectWrap::Unwrap<VRPStream>(info.Holder());
+
+  if (!self->decoder)
+    throw std::runtime_error{"Stream already ended"};
+
+  if (!self->decoder->done())
+    throw std::runtime_error{"Unexpected end of stream"};
+
+  // Release our handle on the storage, the VRP object owns it from now on
+  std::unique_ptr<StreamDecoder> decoder{std::move(self->decoder)};
+
+  info.GetReturnValue().Set(makeVRPFromDecoder(*decoder, self->compressMatrices));
+
+} catch (const std::exception& e) {
+  return Nan::ThrowError(e.what());
+}
+
+Nan::Persistent<v8::Function>& VRPStream::constructor() {
+  static Nan::Persistent<v8::Function> init;
+  return init;
+}
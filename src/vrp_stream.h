@@ -0,0 +1,35 @@
+#ifndef NODE_OR_TOOLS_VRP_STREAM_3B8E55A1D0F6_H
+#define NODE_OR_TOOLS_VRP_STREAM_3B8E55A1D0F6_H
+
+#include <nan.h>
+
+#include "stream_decoder.h"
+
+#include <memory>
+
+// Builds VRP objects from binary instances (see stream_decoder.h) without materializing JS arrays:
+//  - VRP.fromFd(fd, opts, callback) reads and decodes on a worker thread
+//  - new VRP.Stream(opts) decodes chunks handed over from a Readable, see lib/index.js
+class VRPStream : public Nan::ObjectWrap {
+public:
+  static NAN_MODULE_INIT(Init);
+
+  static NAN_METHOD(FromFd);
+
+private:
+  static NAN_METHOD(New);
+
+  static NAN_METHOD(Write);
+  static NAN_METHOD(End);
+
+  static Nan::Persistent<v8::Function>& constructor();
+
+  // Wrapped Object
+
+  VRPStream(std::unique_ptr<StreamDecoder> decoder, bool compressMatrices);
+
+  std::unique_ptr<StreamDecoder> decoder;
+  bool compressMatrices;
+};
+
+#endif
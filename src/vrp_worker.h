@@ -4,11 +4,27 @@
 #include <nan.h>
 
 #include "adaptors.h"
+#include "construct.h"
+#include "cpu_time.h"
+#include "islands.h"
+#include "pickup_delivery.h"
+#include "reduction.h"
+#include "scheduler.h"
+#include "search_stats.h"
+#include "single_flight.h"
+#include "symmetry.h"
+#include "time_dependent.h"
 #include "types.h"
+#include "vrp_params.h"
 
 #include <algorithm>
+#include <chrono>
+#include <deque>
 #include <iterator>
 #include <memory>
+#include <numeric>
+#include <string>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -19,60 +35,156 @@ struct RoutingSolution {
   std::vector<std::vector<NodeIndex>> routes;
   std::vector<std::vector<Interval>> times;
   std::vector<std::vector<int64_t>> costDetails;
+  SearchStats stats;
 };
 
+// A routing model together with the adaptors its callbacks point into: must stay in place once set up.
+struct RoutingInstance {
+  using CostAdaptor = decltype(makeDepotCopiesAdaptor(std::declval<const CostMatrix&>(), 0));
+  using DurationAdaptor = decltype(makeDepotCopiesAdaptor(std::declval<const DurationMatrix&>(), 0));
+  using DemandAdaptor = decltype(makeDepotCopiesAdaptor(std::declval<const DemandMatrix&>(), 0, 0));
+  using ResourceAdaptor = decltype(makeDepotCopiesAdaptor(std::declval<const ResourceDemands&>(), 0, 0));
+  using DistanceAdaptor = decltype(makeDepotCopiesAdaptor(std::declval<const DistanceMatrix&>(), 0));
+
+  RoutingInstance(CostAdaptor costAdaptor_, DurationAdaptor durationAdaptor_, DemandAdaptor demandAdaptor_,
+                  DistanceAdaptor distanceAdaptor_)
+      : costAdaptor{std::move(costAdaptor_)},
+        durationAdaptor{std::move(durationAdaptor_)},
+        demandAdaptor{std::move(demandAdaptor_)},
+        distanceAdaptor{std::move(distanceAdaptor_)} {}
+
+  CostAdaptor costAdaptor;
+  DurationAdaptor durationAdaptor;
+  DemandAdaptor demandAdaptor;
+  DistanceAdaptor distanceAdaptor;
+  std::deque<ResourceAdaptor> resourceAdaptors; // Stable addresses for their callbacks
+
+  std::unique_ptr<RoutingModel> model;
+  ort::RoutingDimension* timeDimension = nullptr; // Unless there is no time dimension
+  SearchStats stats;
+  bool validLocks = false;
+};
+
+// Cached vectors and matrices a solve works on, shared with the VRP object they come from
+struct VRPInstance {
+  std::shared_ptr<const CostMatrix> costs;
+  std::shared_ptr<const DurationMatrix> durations;
+  std::shared_ptr<const TimeWindows> timeWindows;
+  std::shared_ptr<const DemandMatrix> demands;
+  std::shared_ptr<const TimeDependentDurations> timeDependentDurations;
+  std::shared_ptr<const Resources> resources;
+  std::shared_ptr<const DistanceMatrix> distances;
+};
+
+// Same instance data: cheap for solves on the same VRP object, compares element-wise up to the first difference otherwise
+inline bool sameInstance(const VRPInstance& lhs, const VRPInstance& rhs) {
+  if (lhs.costs == rhs.costs)
+    return true; // VRP objects never change their data
+
+  const auto sameTimeWindows = [](const TimeWindows& l, const TimeWindows& r) {
+    if (l.size() != r.size())
+      return false;
+
+    for (std::int32_t node = 0; node < l.size(); ++node)
+      if (l.at(node).start != r.at(node).start || l.at(node).stop != r.at(node).stop)
+        return false;
+
+    return true;
+  };
+
+  const auto sameResource = [](const ResourceDemands& l, const ResourceDemands& r) {
+    if (l.name != r.name || l.perArc != r.perArc || l.dim() != r.dim())
+      return false;
+
+    if (l.perArc)
+      return sameMatrix(l.arcs, r.arcs);
+
+    for (std::int32_t node = 0; node < l.nodes.size(); ++node)
+      if (l.nodes.at(node) != r.nodes.at(node))
+        return false;
+
+    return true;
+  };
+
+  return sameMatrix(*lhs.costs, *rhs.costs) && sameMatrix(*lhs.durations, *rhs.durations) &&
+         sameTimeWindows(*lhs.timeWindows, *rhs.timeWindows) && sameMatrix(*lhs.demands, *rhs.demands) &&
+         lhs.timeDependentDurations->same(*rhs.timeDependentDurations) && sameMatrix(*lhs.distances, *rhs.distances) &&
+         std::equal(lhs.resources->begin(), lhs.resources->end(), rhs.resources->begin(), rhs.resources->end(), sameResource);
+}
+
+using VRPFlight = Flight<VRPInstance>;
+using VRPSingleFlight = SingleFlight<VRPInstance>;
+
 struct VRPWorker final : Nan::AsyncWorker {
   using Base = Nan::AsyncWorker;
 
-  VRPWorker(std::shared_ptr<const CostMatrix> costs_,         //
-            std::shared_ptr<const DurationMatrix> durations_, //
-            std::shared_ptr<const TimeWindows> timeWindows_,  //
-            std::shared_ptr<const DemandMatrix> demands_,     //
-            Nan::Callback* callback,                          //
-            const RoutingModelParameters& modelParams_,       //
-            const RoutingSearchParameters& searchParams_,     //
-            std::int32_t numNodes_,                           //
-            std::int32_t numVehicles_,                        //
-            std::int32_t vehicleDepot_,                       //
-            std::int32_t timeHorizon_,                        //
-            std::vector<int64> vehicleCapacities_,              //   type changed to vector int64
-            RouteLocks routeLocks_,                           //
-            Pickups pickups_,                                 //
-            Deliveries deliveries_)                           //
+  VRPWorker(VRPInstance instance,                              //
+            std::shared_ptr<const VRPSearchParams> config_,    //
+            Nan::Callback* callback,                           //
+            const RoutingModelParameters& modelParams_,        //
+            const RoutingSearchParameters& searchParams_)      //
       : Base(callback),
         // Cached vectors and matrices
-        costs{std::move(costs_)},
-        durations{std::move(durations_)},
-        timeWindows{std::move(timeWindows_)},
-        demands{std::move(demands_)},
-        // Search settings
-        numNodes{numNodes_},
-        numVehicles{numVehicles_},
-        vehicleDepot{vehicleDepot_},
-        timeHorizon{timeHorizon_},
-        vehicleCapacities{std::move(vehicleCapacities_)},
-        routeLocks{std::move(routeLocks_)},
-        pickups{std::move(pickups_)},
-        deliveries{std::move(deliveries_)},
-        // Setup model
-        model{numNodes, numVehicles, NodeIndex{vehicleDepot}, modelParams_},
+        costs{std::move(instance.costs)},
+        durations{std::move(instance.durations)},
+        timeWindows{std::move(instance.timeWindows)},
+        demands{std::move(instance.demands)},
+        timeDependentDurations{std::move(instance.timeDependentDurations)},
+        resources{std::move(instance.resources)},
+        distances{std::move(instance.distances)},
+        // Search settings, shared with the SearchConfig they may come from
+        config{std::move(config_)},
+        numNodes{costs->dim()},
+        numVehicles{config->numVehicles},
+        vehicleDepot{config->depotNode},
+        timeHorizon{config->timeHorizon},
+        // Model gets set up in Execute, see below
         modelParams{modelParams_},
-        searchParams{searchParams_} {
+        searchParams{searchParams_},
+        submitted{Scheduler::Clock::now()} {
 
+    // Durations, time windows and demands are optional: empty when left out or trivial, see VRP::New
     const auto costsOk = costs->dim() == numNodes;
-    const auto durationsOk = durations->dim() == numNodes;
-    const auto timeWindowsOk = timeWindows->size() == numNodes;
-    const auto demandsOk = demands->dim() == numNodes;
+    const auto durationsOk = durations->dim() == numNodes || durations->dim() == 0;
+    const auto timeWindowsOk = timeWindows->size() == numNodes || timeWindows->size() == 0;
+    const auto demandsOk = demands->dim() == numNodes || demands->dim() == 0;
+    const auto timeDependentDurationsOk = timeDependentDurations->empty() || timeDependentDurations->dim() == numNodes;
 
-    if (!costsOk || !durationsOk || !timeWindowsOk || !demandsOk)
+    if (!costsOk || !durationsOk || !timeWindowsOk || !demandsOk || !timeDependentDurationsOk)
       throw std::runtime_error{"Expected costs, durations, timeWindow and demand sizes to match numNodes"};
 
-    const auto routeLocksOk = (std::int32_t)routeLocks.size() == numVehicles;
+    const auto vehicleCapacitiesOk = (std::int32_t)config->vehicleCapacities.size() == numVehicles ||
+                                     (demands->dim() == 0 && config->vehicleCapacities.empty());
+
+    if (!vehicleCapacitiesOk)
+      throw std::runtime_error{"Expected vehicleCapacities size to match numVehicles"};
+
+    for (const auto& resource : *resources) {
+      if (resource.dim() != numNodes)
+        throw std::runtime_error{"Expected resource demand sizes to match numNodes"};
+
+      const auto capacities = config->resourceCapacities.find(resource.name);
+
+      if (capacities == config->resourceCapacities.end())
+        throw std::runtime_error{"Expected resourceCapacities for resource '" + resource.name + "'"};
+
+      if ((std::int32_t)capacities->second.size() != numVehicles)
+        throw std::runtime_error{"Expected resourceCapacities sizes to match numVehicles"};
+    }
+
+    for (const auto& capacities : config->resourceCapacities) {
+      const auto isResource = [&](const ResourceDemands& resource) { return resource.name == capacities.first; };
+
+      if (std::none_of(resources->begin(), resources->end(), isResource))
+        throw std::runtime_error{"Expected resourceCapacities only for resources, got '" + capacities.first + "'"};
+    }
+
+    const auto routeLocksOk = (std::int32_t)config->routeLocks.size() == numVehicles;
 
     if (!routeLocksOk)
       throw std::runtime_error{"Expected routeLocks size to match numVehicles"};
 
-    for (const auto& locks : routeLocks) {
+    for (const auto& locks : config->routeLocks) {
       for (const auto& node : locks) {
         const auto nodeInBounds = node >= 0 && node < numNodes;
 
@@ -86,103 +198,157 @@ struct VRPWorker final : Nan::AsyncWorker {
       }
     }
 
-    const auto pickupsAndDeliveriesOk = pickups.size() == deliveries.size();
+    const auto pickupsAndDeliveriesOk = config->pickups.size() == config->deliveries.size();
 
     if (!pickupsAndDeliveriesOk)
       throw std::runtime_error{"Expected pickups and deliveries parallel array sizes to match"};
-  }
 
-  void Execute() override {
-    auto costAdaptor = makeBinaryAdaptor(*costs);
-    auto costCallback = makeCallback(costAdaptor);
+    const auto pickupDeliveryOrderOk = config->pickupDeliveryPolicy.order == PickupDeliveryOrder::Any ||
+                                       config->pickupDeliveryPolicy.mode == PickupDeliveryMode::Paths;
 
-    model.SetArcCostEvaluatorOfAllVehicles(costCallback);
+    if (!pickupDeliveryOrderOk)
+      throw std::runtime_error{"Expected pickupDeliveryMode 'paths' for loading orders"};
 
-    // Time Dimension
+    const auto contractLocksOk = !config->contractLocks || timeDependentDurations->empty();
 
-    auto durationAdaptor = makeBinaryAdaptor(*durations);
-    auto durationCallback = makeCallback(durationAdaptor);
+    if (!contractLocksOk)
+      throw std::runtime_error{"Expected static durations for contracting locks"};
 
-    const static auto kDimensionTime = "time";
+    const auto reloadsOk = config->reloads >= 0 && (config->reloads == 0 || timeDependentDurations->empty());
 
-    model.AddDimension(durationCallback, timeHorizon, timeHorizon, /*fix_start_cumul_to_zero=*/true, kDimensionTime);
-    const auto& timeDimension = model.GetDimensionOrDie(kDimensionTime);
+    if (!reloadsOk)
+      throw std::runtime_error{"Expected non-negative reloads and static durations for reloads"};
 
-    for (std::int32_t node = 0; node < numNodes; ++node) {
-      const auto interval = timeWindows->at(node);
-      timeDimension.CumulVar(node)->SetRange(interval.start, interval.stop);
-      // At the moment we only support a single interval for time windows.
-      // We can support multiple intervals if we sort intervals by start then stop.
-      // Then Cumulval(n)->SetRange(minStart, maxStop), then walk over intervals
-      // removing intervals between active intervals:
-      // CumulVar(n)->RemoveInterval(stop, start).
+    const auto allowedVehiclesOk = config->allowedVehicles.size() == 0 || config->allowedVehicles.size() == numNodes;
+
+    if (!allowedVehiclesOk)
+      throw std::runtime_error{"Expected allowedVehicles size to match numNodes"};
+
+    for (std::int32_t node = 0; node < config->allowedVehicles.size(); ++node) {
+      if (node == vehicleDepot && config->allowedVehicles.restricted(node))
+        throw std::runtime_error{"Expected depot not to restrict vehicles"};
+
+      for (const auto vehicle : config->allowedVehicles.at(node))
+        if (vehicle < 0 || vehicle >= numVehicles)
+          throw std::runtime_error{"Expected allowed vehicles to be in [0, numVehicles - 1]"};
     }
 
-    // Capacity Dimension
+    const auto softTimeWindowsOk = config->softTimeWindows.size() == 0 || config->softTimeWindows.size() == numNodes;
 
-    auto demandAdaptor = makeBinaryAdaptor(*demands);
-    auto demandCallback = makeCallback(demandAdaptor);
+    if (!softTimeWindowsOk)
+      throw std::runtime_error{"Expected softTimeWindows size to match numNodes"};
 
-    const static auto kDimensionCapacity = "capacity";
+    if (config->softTimeWindows.size() > 0 && config->softTimeWindows.at(vehicleDepot).penalized())
+      throw std::runtime_error{"Expected depot not to have a soft time window"};
 
-    //function for handling different capacitated vehicles
-    model.AddDimensionWithVehicleCapacity(demandCallback, /*slack=*/0, vehicleCapacities, /*fix_start_cumul_to_zero=*/true, kDimensionCapacity);
+    const auto distancesOk = distances->dim() == numNodes || distances->dim() == 0;
+    const auto maxRouteLengthsOk = config->maxRouteLengths.empty() || (std::int32_t)config->maxRouteLengths.size() == numVehicles;
 
+    if (!distancesOk || !maxRouteLengthsOk)
+      throw std::runtime_error{"Expected distances size to match numNodes and maxRouteLengths size to match numVehicles"};
 
-    // Pickup and Deliveries
+    const auto& shifts = config->vehicleShifts;
+    const auto vehicleShiftsOk = (shifts.windows.empty() || (std::int32_t)shifts.windows.size() == numVehicles) &&
+                                 shifts.maxRouteDuration >= 0 && shifts.spanCost >= 0;
 
-    auto* solver = model.solver();
+    if (!vehicleShiftsOk)
+      throw std::runtime_error{"Expected vehicleShifts size to match numVehicles, non-negative maxRouteDuration and spanCost"};
 
-    for (std::int32_t atIdx = 0; atIdx < pickups.size(); ++atIdx) {
-      const auto pickupIndex = model.NodeToIndex(pickups.at(atIdx));
-      const auto deliveryIndex = model.NodeToIndex(deliveries.at(atIdx));
+    const auto islandPolicyOk = config->islandPolicy.islands >= 0 && config->islandPolicy.syncInterval > 0;
 
-      auto* sameRouteCt = solver->MakeEquality(model.VehicleVar(pickupIndex),    //
-                                               model.VehicleVar(deliveryIndex)); //
+    if (!islandPolicyOk)
+      throw std::runtime_error{"Expected non-negative islands and a positive islandSyncInterval"};
 
-      auto* pickupBeforeDeliveryCt = solver->MakeLessOrEqual(timeDimension.CumulVar(pickupIndex),    //
-                                                             timeDimension.CumulVar(deliveryIndex)); //
+    for (const auto& route : config->initialRoutes)
+      for (const auto& node : route)
+        if (node.value() < 0 || node.value() >= numNodes)
+          throw std::runtime_error{"Expected nodes in initial routes to be in [0, numNodes - 1]"};
 
-      solver->AddConstraint(sameRouteCt);
-      solver->AddConstraint(pickupBeforeDeliveryCt);
+    if (config->engine == SearchEngine::Construct && !constructSupported())
+      throw std::runtime_error{"Expected only costs, durations, timeWindows and demands for engine 'construct'"};
 
-      model.AddPickupAndDelivery(pickups.at(atIdx), deliveries.at(atIdx));
-    }
+    // Interleaved with other solves once the scheduler is on; islands and multi-start bring threads of their own
+    scheduled = Scheduler::get().enabled() && config->engine == SearchEngine::Routing && config->islandPolicy.islands <= 1 &&
+                config->firstSolutionStrategies.size() <= 1;
+  }
 
-    // Done with modifications to the routing model
+  void Execute() override {
+    // Instant preview plans without setting up a model
+    if (config->engine == SearchEngine::Construct)
+      return executeConstruct();
 
-    model.CloseModel();
+    // Optional: solve with locked chains contracted into single nodes, expanded again below
+    if (config->contractLocks)
+      contractLockedChains();
 
-    // Locking routes into place needs to happen after the model is closed and the underlying vars are established
-    const auto validLocks = model.ApplyLocksToAllVehicles(routeLocks, /*close_routes=*/false);
+    Scheduler::Task task{submitted, std::chrono::milliseconds(searchParams.time_limit_ms()), config->tenant};
+    std::unique_ptr<Scheduler::Slot> slot;
 
-    if (!validLocks)
+    if (scheduled)
+      slot = std::make_unique<Scheduler::Slot>(task);
+
+    auto instance = setUpModel(scheduled ? &task : nullptr);
+
+    if (!instance->validLocks)
       return SetErrorMessage("Invalid locks");
 
-    const auto* assignment = model.SolveWithParameters(searchParams);
+    auto& model = instance->model;
+    auto& stats = instance->stats;
+
+    const auto hasTimeDimension = instance->timeDimension != nullptr;
+    const auto* timeDimension = instance->timeDimension;
+
+    const auto solveStart = std::chrono::steady_clock::now();
+    const auto solveStartCpu = threadCpuTime();
+
+    const auto* assignment = [&] {
+      if (config->islandPolicy.islands > 1)
+        return solveWithIslands(*model, stats);
+
+      if (config->firstSolutionStrategies.size() > 1)
+        return solveFromMultiStart(*model);
+
+      const auto params = scheduled ? makeScheduledParams() : searchParams;
+
+      // Optional: search on from a known solution, e.g. the best across a portfolio; see lib/portfolio.js
+      if (const auto* initial = readInitialRoutes(*model))
+        return model->SolveFromAssignmentWithParameters(initial, params);
+
+      return model->SolveWithParameters(params);
+    }();
 
-    if (!assignment || (model.status() != RoutingModel::Status::ROUTING_SUCCESS))
+    const auto solveTime = std::chrono::steady_clock::now() - solveStart;
+    stats.wallTime = std::chrono::duration_cast<std::chrono::milliseconds>(solveTime).count();
+    stats.waitTime = std::chrono::duration_cast<std::chrono::milliseconds>(task.waitTime()).count();
+    stats.cpuTime = std::chrono::duration_cast<std::chrono::milliseconds>(threadCpuTime() - solveStartCpu).count();
+    stats.budget = std::chrono::duration_cast<std::chrono::milliseconds>(task.budget()).count();
+
+    if (!assignment || (model->status() != RoutingModel::Status::ROUTING_SUCCESS))
       return SetErrorMessage("Unable to find a solution");
 
     const auto cost = static_cast<std::int64_t>(assignment->ObjectiveValue());
 
     std::vector<std::vector<NodeIndex>> routes;
-    model.AssignmentToRoutes(*assignment, &routes);
+    model->AssignmentToRoutes(*assignment, &routes);
 
     std::vector<std::vector<Interval>> times;
 
     for (const auto& route : routes) {
       std::vector<Interval> routeTimes;
 
-      for (const auto& node : route) {
-        const auto index = model.NodeToIndex(node);
+      if (hasTimeDimension) {
+        for (const auto& node : route) {
+          const auto index = model->NodeToIndex(node);
 
-        const auto* timeVar = timeDimension.CumulVar(index);
+          const auto* timeVar = timeDimension->CumulVar(index);
 
-        const auto first = static_cast<std::int32_t>(assignment->Min(timeVar));
-        const auto last = static_cast<std::int32_t>(assignment->Max(timeVar));
+          const auto first = static_cast<std::int32_t>(assignment->Min(timeVar));
+          const auto last = static_cast<std::int32_t>(assignment->Max(timeVar));
 
-        routeTimes.push_back(Interval{first, last});
+          routeTimes.push_back(Interval{first, last});
+        }
+      } else {
+        routeTimes = makeUnconstrainedRouteTimes(route);
       }
 
       times.push_back(std::move(routeTimes));
@@ -193,23 +359,99 @@ struct VRPWorker final : Nan::AsyncWorker {
 
       for (int vehicle_id = 0; vehicle_id < numVehicles; ++vehicle_id) {
         std::vector<int64_t> routeCosts;
-        int64_t index = model.Start(vehicle_id);
+        int64_t index = model->Start(vehicle_id);
         std::stringstream route;
-        while (!model.IsEnd(index)) {
+        while (!model->IsEnd(index)) {
           const int64_t previous_index = index;
-          index = assignment->Value(model.NextVar(index));
-          const auto _cost = model.GetArcCostForVehicle(previous_index, index, int64_t{vehicle_id});
+          index = assignment->Value(model->NextVar(index));
+          const auto _cost = model->GetArcCostForVehicle(previous_index, index, int64_t{vehicle_id});
+
+          if (contraction && !model->IsStart(previous_index) && !isReload(model->IndexToNode(previous_index))) {
+            const auto arcCosts = contraction->expandArcCost(model->IndexToNode(previous_index).value(), _cost);
+            routeCosts.insert(routeCosts.end(), arcCosts.begin(), arcCosts.end());
+            continue;
+          }
+
           routeCosts.push_back(_cost);
         }
         costDetails.push_back(std::move(routeCosts));
       }
 
-    solution = RoutingSolution{cost, std::move(routes), std::move(times), std::move(costDetails)};
+    // Reloads are visits to the depot for the user
+    for (auto& route : routes)
+      for (auto& node : route)
+        if (isReload(node))
+          node = NodeIndex{vehicleDepot};
+
+    // Back from contracted chains to the user's nodes; inner nodes follow their head without waiting
+    if (contraction) {
+      for (std::size_t vehicle = 0; vehicle < routes.size(); ++vehicle) {
+        std::vector<Interval> routeTimes;
+
+        for (std::size_t atIdx = 0; atIdx < routes[vehicle].size(); ++atIdx) {
+          const auto head = times[vehicle][atIdx];
+
+          for (const auto node : contraction->expand(routes[vehicle][atIdx].value())) {
+            const auto offset = static_cast<std::int32_t>(contraction->offset(node));
+            routeTimes.push_back(Interval{head.start + offset, head.stop + offset});
+          }
+        }
+
+        routes[vehicle] = contraction->expandRoute(routes[vehicle]);
+        times[vehicle] = std::move(routeTimes);
+      }
+    }
+
+    solution = RoutingSolution{cost, std::move(routes), std::move(times), std::move(costDetails), stats};
   }
 
   void HandleOKCallback() override {
     Nan::HandleScope scope;
 
+    callAll([this] { return std::vector<v8::Local<v8::Value>>{Nan::Null(), makeJsSolution()}; });
+  }
+
+  void HandleErrorCallback() override {
+    Nan::HandleScope scope;
+
+    callAll([this] { return std::vector<v8::Local<v8::Value>>{Nan::Error(ErrorMessage())}; });
+  }
+
+  // Coalesced solves waiting for this one get the same result, see single_flight.h. Every callback gets arguments of
+  // its own from makeArgv: one mutating its result must not change what the others see. Exceptions thrown by callbacks
+  // are reported once all of them got called, the first one as uncaught exception.
+  template <typename MakeArgv> void callAll(MakeArgv makeArgv) {
+    if (flight)
+      VRPSingleFlight::get().land(*flight);
+
+    v8::Local<v8::Value> exception;
+
+    const auto call = [&](Nan::Callback& target) {
+      Nan::TryCatch tryCatch;
+
+      auto argv = makeArgv();
+      target.Call(static_cast<int>(argv.size()), argv.data());
+
+      if (tryCatch.HasCaught() && exception.IsEmpty())
+        exception = tryCatch.Exception();
+    };
+
+    call(*callback);
+
+    if (flight)
+      for (const auto& follower : flight->followers)
+        call(*follower);
+
+    if (!exception.IsEmpty()) {
+      Nan::TryCatch tryCatch;
+      v8::Isolate::GetCurrent()->ThrowException(exception);
+      Nan::FatalException(tryCatch);
+    }
+  }
+
+  v8::Local<v8::Object> makeJsSolution() const {
+    Nan::EscapableHandleScope scope;
+
     auto jsSolution = Nan::New<v8::Object>();
 
     auto jsCost = Nan::New<v8::Number>(solution.cost);
@@ -256,10 +498,717 @@ struct VRPWorker final : Nan::AsyncWorker {
     Nan::Set(jsSolution, Nan::New("times").ToLocalChecked(), jsTimes);
     Nan::Set(jsSolution, Nan::New("costDetails").ToLocalChecked(), jsCostDetails);
 
-    const auto argc = 2u;
-    v8::Local<v8::Value> argv[argc] = {Nan::Null(), jsSolution};
+    auto jsStats = Nan::New<v8::Object>();
+
+    Nan::Set(jsStats, Nan::New("solutions").ToLocalChecked(), Nan::New<v8::Number>(solution.stats.solutions));
+    Nan::Set(jsStats, Nan::New("wallTime").ToLocalChecked(), Nan::New<v8::Number>(solution.stats.wallTime));
+    Nan::Set(jsStats, Nan::New("waitTime").ToLocalChecked(), Nan::New<v8::Number>(solution.stats.waitTime));
+    Nan::Set(jsStats, Nan::New("cpuTime").ToLocalChecked(), Nan::New<v8::Number>(solution.stats.cpuTime));
+    Nan::Set(jsStats, Nan::New("budget").ToLocalChecked(), Nan::New<v8::Number>(solution.stats.budget));
+
+    if (!solution.stats.islands.empty()) {
+      auto jsIslands = Nan::New<v8::Array>(solution.stats.islands.size());
 
-    callback->Call(argc, argv);
+      for (std::size_t i = 0; i < solution.stats.islands.size(); ++i) {
+        const auto& improvements = solution.stats.islands[i];
+
+        auto jsImprovements = Nan::New<v8::Array>(improvements.size());
+
+        for (std::size_t j = 0; j < improvements.size(); ++j) {
+          auto jsImprovement = Nan::New<v8::Array>(2);
+
+          Nan::Set(jsImprovement, 0, Nan::New<v8::Number>(improvements[j].first));
+          Nan::Set(jsImprovement, 1, Nan::New<v8::Number>(improvements[j].second));
+
+          Nan::Set(jsImprovements, j, jsImprovement);
+        }
+
+        Nan::Set(jsIslands, i, jsImprovements);
+      }
+
+      Nan::Set(jsStats, Nan::New("islands").ToLocalChecked(), jsIslands);
+    }
+
+    Nan::Set(jsSolution, Nan::New("stats").ToLocalChecked(), jsStats);
+
+    return scope.Escape(jsSolution);
+  }
+
+  // Swaps the cached data for data on contracted nodes, see reduction.h. Pickup and delivery nodes stay as they are.
+  // Sets up and closes a routing model over the (possibly contracted) data; the search is left to the caller.
+  // Models share no state, so several of them can be set up and searched concurrently.
+  // The task yields to the scheduler from within the search and limits it to its run time, see scheduler.h
+  std::unique_ptr<RoutingInstance> setUpModel(Scheduler::Task* task = nullptr) const {
+    // Reload stops are copies of the depot past the user's nodes; adaptors remap them onto the depot
+    // Reloads empty the vehicle: leaving them drops the load by the largest capacity, slack takes up the rest
+    const auto& vehicleCapacities = config->vehicleCapacities;
+    const auto maxCapacity =
+        vehicleCapacities.empty() ? 0 : *std::max_element(vehicleCapacities.begin(), vehicleCapacities.end());
+
+    auto instance = std::make_unique<RoutingInstance>(makeDepotCopiesAdaptor(*costs, vehicleDepot),                  //
+                                                      makeDepotCopiesAdaptor(*durations, vehicleDepot),              //
+                                                      makeDepotCopiesAdaptor(*demands, vehicleDepot, -maxCapacity), //
+                                                      makeDepotCopiesAdaptor(*distances, vehicleDepot));            //
+
+    auto& model = instance->model;
+    model = std::make_unique<RoutingModel>(numNodes + config->reloads, numVehicles, NodeIndex{vehicleDepot}, modelParams);
+
+    auto costCallback = makeCallback(instance->costAdaptor);
+
+    model->SetArcCostEvaluatorOfAllVehicles(costCallback);
+
+    // Time Dimension: only when windows, the horizon or constraints on arrival times can actually bind
+
+    auto durationCallback = makeCallback(instance->durationAdaptor);
+
+    const static auto kDimensionTime = "time";
+
+    const auto hasTimeDimension = needsTimeDimension();
+    ort::RoutingDimension* timeDimension = nullptr;
+
+    // With shifts vehicles may leave late: only then route starts can move away from zero
+    const auto hasShifts = needsVehicleShifts();
+
+    if (hasTimeDimension) {
+      model->AddDimension(durationCallback, timeHorizon, timeHorizon, /*fix_start_cumul_to_zero=*/!hasShifts, kDimensionTime);
+      timeDimension = model->GetMutableDimension(kDimensionTime);
+    }
+
+    auto* solver = model->solver();
+
+    // Static transits above are lower bounds; the constraints add the departure-dependent part via slack
+    if (!timeDependentDurations->empty()) {
+      for (std::int32_t index = 0; index < model->Size(); ++index) {
+        auto* transitCt = new TimeDependentTransitConstraint{solver, *model, *timeDimension, *timeDependentDurations, index};
+        solver->AddConstraint(solver->RevAlloc(transitCt));
+      }
+    }
+
+    for (std::int32_t node = 0; hasTimeDimension && node < timeWindows->size(); ++node) {
+      const auto interval = timeWindows->at(node);
+      timeDimension->CumulVar(node)->SetRange(interval.start, interval.stop);
+      // At the moment we only support a single interval for time windows.
+      // We can support multiple intervals if we sort intervals by start then stop.
+      // Then Cumulval(n)->SetRange(minStart, maxStop), then walk over intervals
+      // removing intervals between active intervals:
+      // CumulVar(n)->RemoveInterval(stop, start).
+    }
+
+    // Linear penalties for being early or late: the search reaches slightly late plans instead of no plan at all
+    for (std::int32_t node = 0; node < config->softTimeWindows.size(); ++node) {
+      const auto& window = config->softTimeWindows.at(node);
+
+      if (window.earlyPenalty > 0)
+        timeDimension->SetCumulVarSoftLowerBound(NodeIndex{node}, window.start, window.earlyPenalty);
+
+      if (window.latePenalty > 0)
+        timeDimension->SetCumulVarSoftUpperBound(NodeIndex{node}, window.stop, window.latePenalty);
+    }
+
+    for (std::int32_t vehicle = 0; hasShifts && vehicle < (std::int32_t)config->vehicleShifts.windows.size(); ++vehicle) {
+      const auto shift = config->vehicleShifts.windows[vehicle];
+
+      timeDimension->CumulVar(model->Start(vehicle))->SetRange(shift.start, shift.stop);
+      timeDimension->CumulVar(model->End(vehicle))->SetRange(shift.start, shift.stop);
+    }
+
+    const auto limitsRouteDuration = hasShifts && config->vehicleShifts.maxRouteDuration < timeHorizon;
+
+    for (std::int32_t vehicle = 0; limitsRouteDuration && vehicle < numVehicles; ++vehicle) {
+      auto* routeDuration = solver->MakeDifference(timeDimension->CumulVar(model->End(vehicle)),    //
+                                                   timeDimension->CumulVar(model->Start(vehicle))); //
+
+      solver->AddConstraint(solver->MakeLessOrEqual(routeDuration, config->vehicleShifts.maxRouteDuration));
+    }
+
+    if (config->vehicleShifts.spanCost > 0)
+      timeDimension->SetSpanCostCoefficientForAllVehicles(config->vehicleShifts.spanCost);
+
+    for (std::int32_t reload = 0; hasTimeDimension && timeWindows->size() > 0 && reload < config->reloads; ++reload) {
+      const auto interval = timeWindows->at(vehicleDepot);
+      timeDimension->CumulVar(model->NodeToIndex(NodeIndex{numNodes + reload}))->SetRange(interval.start, interval.stop);
+    }
+
+    // Capacity Dimension: only when some vehicle could run out of capacity
+
+    auto demandCallback = makeCallback(instance->demandAdaptor);
+
+    const static auto kDimensionCapacity = "capacity";
+
+    std::vector<const ort::RoutingDimension*> reloadDimensions;
+
+    //function for handling different capacitated vehicles
+    if (needsCapacityDimension()) {
+      model->AddDimensionWithVehicleCapacity(demandCallback, /*slack=*/config->reloads > 0 ? maxCapacity : 0,
+                                             vehicleCapacities, /*fix_start_cumul_to_zero=*/true, kDimensionCapacity);
+      reloadDimensions.push_back(&model->GetDimensionOrDie(kDimensionCapacity));
+    }
+
+    // One capacity dimension per named resource
+
+    for (const auto& resource : *resources) {
+      const auto& capacities = config->resourceCapacities.at(resource.name);
+      const auto maxResourceCapacity = capacities.empty() ? 0 : *std::max_element(capacities.begin(), capacities.end());
+
+      instance->resourceAdaptors.push_back(makeDepotCopiesAdaptor(resource, vehicleDepot, -maxResourceCapacity));
+      auto resourceCallback = makeCallback(instance->resourceAdaptors.back());
+
+      const auto name = kDimensionCapacity + (":" + resource.name);
+
+      model->AddDimensionWithVehicleCapacity(resourceCallback, /*slack=*/config->reloads > 0 ? maxResourceCapacity : 0,
+                                             capacities, /*fix_start_cumul_to_zero=*/true, name);
+      reloadDimensions.push_back(&model->GetDimensionOrDie(name));
+    }
+
+    // Distance Dimension: route lengths in distances, or in costs if there are none, up to each vehicle's range
+
+    const static auto kDimensionDistance = "distance";
+
+    if (!config->maxRouteLengths.empty()) {
+      RoutingModel::NodeEvaluator2* distanceCallback =
+          distances->dim() == 0 ? makeCallback(instance->costAdaptor) : makeCallback(instance->distanceAdaptor);
+
+      model->AddDimensionWithVehicleCapacity(distanceCallback, /*slack=*/0, config->maxRouteLengths,
+                                             /*fix_start_cumul_to_zero=*/true, kDimensionDistance);
+    }
+
+    // Reloads are optional stops at no penalty
+    for (std::int32_t reload = 0; reload < config->reloads; ++reload)
+      model->AddDisjunction({NodeIndex{numNodes + reload}}, /*penalty=*/0);
+
+
+    // Pickup and Deliveries
+
+    if (config->pickupDeliveryPolicy.mode == PickupDeliveryMode::Paths && config->pickups.size() > 0) {
+      auto* pairsCt =
+          new PickupDeliveryConstraint{solver, *model, config->pickups, config->deliveries, config->pickupDeliveryPolicy.order};
+      solver->AddConstraint(solver->RevAlloc(pairsCt));
+    }
+
+    for (std::int32_t atIdx = 0; atIdx < config->pickups.size(); ++atIdx) {
+      const auto pickupIndex = model->NodeToIndex(config->pickups.at(atIdx));
+      const auto deliveryIndex = model->NodeToIndex(config->deliveries.at(atIdx));
+
+      if (config->pickupDeliveryPolicy.mode == PickupDeliveryMode::Constraints) {
+        auto* sameRouteCt = solver->MakeEquality(model->VehicleVar(pickupIndex),    //
+                                                 model->VehicleVar(deliveryIndex)); //
+
+        auto* pickupBeforeDeliveryCt = solver->MakeLessOrEqual(timeDimension->CumulVar(pickupIndex),    //
+                                                               timeDimension->CumulVar(deliveryIndex)); //
+
+        solver->AddConstraint(sameRouteCt);
+        solver->AddConstraint(pickupBeforeDeliveryCt);
+      }
+
+      // Only a hint for the pair-aware local search operators, it does not constrain anything
+      model->AddPickupAndDelivery(config->pickups.at(atIdx), config->deliveries.at(atIdx));
+    }
+
+    // Identical vehicles are interchangeable: relabelled solutions get pruned instead of searched
+    if (config->symmetryBreaking != SymmetryBreaking::None)
+      addSymmetryBreaking(*model, identicalVehicles(), config->symmetryBreaking);
+
+    model->AddSearchMonitor(solver->RevAlloc(new SolutionCounter{solver, instance->stats}));
+
+    if (task)
+      model->AddSearchMonitor(solver->RevAlloc(new ScheduledLimit{solver, *task}));
+
+    if (config->cpuTimeLimit > 0)
+      model->AddSearchMonitor(solver->RevAlloc(new CpuTimeLimit{solver, cpuTimeDeadline()}));
+
+    // Done with modifications to the routing model
+
+    model->CloseModel();
+
+    // Locking routes into place needs to happen after the model is closed and the underlying vars are established
+    instance->validLocks = model->ApplyLocksToAllVehicles(config->routeLocks, /*close_routes=*/false);
+
+    if (!instance->validLocks)
+      return instance;
+
+    if (config->reloads > 0)
+      restrictReloads(model.get(), reloadDimensions);
+
+    // Incompatible vehicles get pruned by propagation instead of evaluated and rejected by cost
+    for (std::int32_t node = 0; node < config->allowedVehicles.size(); ++node)
+      if (config->allowedVehicles.restricted(node))
+        model->VehicleVar(model->NodeToIndex(NodeIndex{node}))->SetValues(config->allowedVehicles.at(node));
+
+    instance->timeDimension = timeDimension;
+
+    return instance;
+  }
+
+  // First solutions by several strategies concurrently, each on a model of its own, get at most half of the time limit.
+  // The cheapest one seeds the local search on `model` for the remaining time.
+  const ort::Assignment* solveFromMultiStart(RoutingModel& model) const {
+    const auto solveStart = std::chrono::steady_clock::now();
+
+    struct FirstSolution {
+      bool found = false;
+      std::int64_t cost = 0;
+      std::vector<std::vector<NodeIndex>> routes;
+    };
+
+    std::vector<FirstSolution> firstSolutions(config->firstSolutionStrategies.size());
+    std::vector<std::thread> threads;
+
+    for (std::size_t atIdx = 0; atIdx < config->firstSolutionStrategies.size(); ++atIdx) {
+      threads.emplace_back([this, atIdx, &firstSolutions] {
+        auto instance = setUpModel();
+
+        if (!instance->validLocks)
+          return;
+
+        auto params = searchParams;
+        params.set_first_solution_strategy(config->firstSolutionStrategies[atIdx]);
+        params.set_solution_limit(1);
+        params.set_time_limit_ms(std::max<int64>(searchParams.time_limit_ms() / 2, 1));
+
+        const auto* assignment = instance->model->SolveWithParameters(params);
+
+        if (!assignment)
+          return;
+
+        auto& firstSolution = firstSolutions[atIdx];
+
+        firstSolution.found = true;
+        firstSolution.cost = assignment->ObjectiveValue();
+        instance->model->AssignmentToRoutes(*assignment, &firstSolution.routes);
+      });
+    }
+
+    for (auto& thread : threads)
+      thread.join();
+
+    const auto best = std::min_element(firstSolutions.begin(), firstSolutions.end(), [](const auto& lhs, const auto& rhs) {
+      return lhs.found && (!rhs.found || lhs.cost < rhs.cost);
+    });
+
+    const auto elapsed = std::chrono::steady_clock::now() - solveStart;
+    const auto remaining = searchParams.time_limit_ms() - std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count();
+
+    auto params = searchParams;
+    params.set_time_limit_ms(std::max<int64>(remaining, 1));
+
+    const auto* initial = best->found ? model.ReadAssignmentFromRoutes(best->routes, /*ignore_inactive_nodes=*/true) : nullptr;
+
+    if (!initial)
+      return model.SolveWithParameters(params);
+
+    return model.SolveFromAssignmentWithParameters(initial, params);
+  }
+
+  // Islands search for syncInterval at a time, publish their best solution and continue from the best across islands.
+  // Islands differ in first solution strategy and metaheuristic. The overall best gets restored into `model`.
+  const ort::Assignment* solveWithIslands(RoutingModel& model, SearchStats& stats) const {
+    const auto solveStart = std::chrono::steady_clock::now();
+    const auto deadline = solveStart + std::chrono::milliseconds(searchParams.time_limit_ms());
+
+    const static std::vector<LocalSearchMetaheuristic::Value> kMetaheuristics{
+        LocalSearchMetaheuristic::GUIDED_LOCAL_SEARCH, //
+        LocalSearchMetaheuristic::SIMULATED_ANNEALING, //
+        LocalSearchMetaheuristic::TABU_SEARCH,         //
+    };
+
+    SharedSolution shared;
+    stats.islands.resize(config->islandPolicy.islands);
+
+    // Each island counts on its own model, see setUpModel
+    std::vector<std::int64_t> islandSolutions(config->islandPolicy.islands);
+
+    std::vector<std::thread> threads;
+
+    for (std::int32_t island = 0; island < config->islandPolicy.islands; ++island) {
+      threads.emplace_back([&, island] {
+        const auto cpuDeadline = cpuTimeDeadline();
+
+        auto instance = setUpModel();
+
+        if (!instance->validLocks)
+          return;
+
+        auto& islandModel = *instance->model;
+        auto& improvements = stats.islands[island];
+
+        auto params = searchParams;
+        params.set_local_search_metaheuristic(kMetaheuristics[island % kMetaheuristics.size()]);
+
+        if (!config->firstSolutionStrategies.empty())
+          params.set_first_solution_strategy(config->firstSolutionStrategies[island % config->firstSolutionStrategies.size()]);
+
+        std::shared_ptr<const IslandSolution> own;
+
+        for (auto now = solveStart; now < deadline; now = std::chrono::steady_clock::now()) {
+          // Out of CPU time: slices from here on would stop right away
+          if (config->cpuTimeLimit > 0 && threadCpuTime() >= cpuDeadline)
+            break;
+
+          const auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now).count();
+          params.set_time_limit_ms(std::max<int64>(std::min<int64>(config->islandPolicy.syncInterval, remaining), 1));
+
+          const auto best = shared.load();
+          const auto& from = best && (!own || best->cost < own->cost) ? best : own;
+
+          const auto* initial =
+              from ? islandModel.ReadAssignmentFromRoutes(from->routes, /*ignore_inactive_nodes=*/true) : nullptr;
+          const auto* assignment = initial ? islandModel.SolveFromAssignmentWithParameters(initial, params)
+                                           : islandModel.SolveWithParameters(params);
+
+          if (!assignment)
+            continue;
+
+          auto found = std::make_shared<IslandSolution>();
+          found->cost = assignment->ObjectiveValue();
+          islandModel.AssignmentToRoutes(*assignment, &found->routes);
+
+          if (own && found->cost >= own->cost)
+            continue;
+
+          const auto elapsed = std::chrono::steady_clock::now() - solveStart;
+          improvements.emplace_back(std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count(), found->cost);
+
+          own = found;
+          shared.publish(own);
+        }
+
+        islandSolutions[island] = instance->stats.solutions;
+      });
+    }
+
+    for (auto& thread : threads)
+      thread.join();
+
+    const auto best = shared.load();
+
+    if (!best)
+      return nullptr;
+
+    // Only restores the best solution: the first solution found from it is the solution itself
+    auto params = searchParams;
+    params.set_solution_limit(1);
+
+    const auto* initial = model.ReadAssignmentFromRoutes(best->routes, /*ignore_inactive_nodes=*/true);
+    const auto* restored = initial ? model.SolveFromAssignmentWithParameters(initial, params) : nullptr;
+
+    // Restoring finds no new solution: the islands' solutions are the search's
+    stats.solutions = std::accumulate(islandSolutions.begin(), islandSolutions.end(), std::int64_t{0});
+
+    return restored;
+  }
+
+  void executeConstruct() {
+    const auto solveStart = std::chrono::steady_clock::now();
+    const auto deadline = solveStart + std::chrono::milliseconds(searchParams.time_limit_ms());
+
+    SavingsConstruction construction{numNodes, numVehicles, vehicleDepot, timeHorizon, *costs, *durations,
+                                     *timeWindows, *demands, config->vehicleCapacities};
+
+    if (!construction.solve(deadline))
+      return SetErrorMessage("Unable to find a solution");
+
+    std::int64_t cost = 0;
+
+    std::vector<std::vector<NodeIndex>> routes;
+    std::vector<std::vector<Interval>> times;
+    std::vector<std::vector<int64_t>> costDetails;
+
+    for (const auto& route : construction.routes()) {
+      cost += construction.cost(route);
+
+      routes.emplace_back(route.begin(), route.end());
+      times.push_back(construction.times(route));
+
+      const auto arcCosts = construction.arcCosts(route);
+      costDetails.emplace_back(arcCosts.begin(), arcCosts.end());
+    }
+
+    SearchStats stats;
+    stats.solutions = 1 + construction.improvements();
+
+    const auto solveTime = std::chrono::steady_clock::now() - solveStart;
+    stats.wallTime = std::chrono::duration_cast<std::chrono::milliseconds>(solveTime).count();
+
+    solution = RoutingSolution{cost, std::move(routes), std::move(times), std::move(costDetails), stats};
+  }
+
+  // The construction engine knows about costs, durations, time windows and demands only
+  bool constructSupported() const {
+    const auto& locks = config->routeLocks;
+    const auto noLocks = std::all_of(locks.begin(), locks.end(), [](const LockChain& lock) { return lock.empty(); });
+
+    return noLocks && timeDependentDurations->empty() && resources->empty() && config->pickups.size() == 0 &&
+           config->reloads == 0 && config->allowedVehicles.size() == 0 && config->softTimeWindows.size() == 0 &&
+           !needsVehicleShifts() && config->maxRouteLengths.empty() && !config->contractLocks;
+  }
+
+  void contractLockedChains() {
+    std::vector<bool> pinned(numNodes, false);
+
+    for (std::int32_t atIdx = 0; atIdx < config->pickups.size(); ++atIdx) {
+      pinned[config->pickups.at(atIdx).value()] = true;
+      pinned[config->deliveries.at(atIdx).value()] = true;
+    }
+
+    for (std::int32_t node = 0; node < config->allowedVehicles.size(); ++node)
+      pinned[node] = pinned[node] || config->allowedVehicles.restricted(node);
+
+    for (std::int32_t node = 0; node < config->softTimeWindows.size(); ++node)
+      pinned[node] = pinned[node] || config->softTimeWindows.at(node).penalized();
+
+    contraction =
+        std::make_unique<ChainContraction>(numNodes, vehicleDepot, config->routeLocks, pinned, *costs, *durations, *timeWindows);
+
+    if (contraction->empty()) {
+      contraction.reset();
+      return;
+    }
+
+    costs = std::make_shared<const CostMatrix>(contraction->reduceMatrix(*costs));
+    durations = std::make_shared<const DurationMatrix>(contraction->reduceMatrix(*durations));
+    timeWindows = std::make_shared<const TimeWindows>(contraction->reduceTimeWindows(*timeWindows));
+    demands = std::make_shared<const DemandMatrix>(contraction->reduceMatrix(*demands));
+    distances = std::make_shared<const DistanceMatrix>(contraction->reduceMatrix(*distances));
+    resources = std::make_shared<const Resources>(contraction->reduceResources(*resources));
+
+    // The config may be shared with a SearchConfig and other solves: reduce a copy of it
+    auto reduced = std::make_shared<VRPSearchParams>(*config);
+
+    reduced->routeLocks = contraction->reduceLocks(reduced->routeLocks);
+    reduced->pickups = contraction->reduceNodes(reduced->pickups);
+    reduced->deliveries = contraction->reduceNodes(reduced->deliveries);
+    reduced->allowedVehicles = contraction->reduceAllowedVehicles(reduced->allowedVehicles);
+    reduced->softTimeWindows = contraction->reduceSoftTimeWindows(reduced->softTimeWindows);
+
+    config = std::move(reduced);
+
+    numNodes = contraction->size();
+    vehicleDepot = contraction->reduce(vehicleDepot);
+  }
+
+  bool isReload(NodeIndex node) const { return node.value() >= numNodes; }
+
+  // Only slack at reloads can empty vehicles. Reloads neither start nor end routes nor follow each other:
+  // such visits would not change loads, they only blow up the search.
+  void restrictReloads(RoutingModel* model, const std::vector<const ort::RoutingDimension*>& dimensions) const {
+    std::vector<int64> reloadIndices;
+
+    for (std::int32_t reload = 0; reload < config->reloads; ++reload)
+      reloadIndices.push_back(model->NodeToIndex(NodeIndex{numNodes + reload}));
+
+    for (std::int32_t index = 0; index < model->Size(); ++index)
+      if (!isReload(model->IndexToNode(index)))
+        for (const auto* dimension : dimensions)
+          dimension->SlackVar(index)->SetValue(0);
+
+    std::vector<int64> routeEnds;
+
+    for (std::int32_t vehicle = 0; vehicle < numVehicles; ++vehicle) {
+      model->NextVar(model->Start(vehicle))->RemoveValues(reloadIndices);
+      routeEnds.push_back(model->End(vehicle));
+    }
+
+    for (const auto index : reloadIndices) {
+      auto* next = model->NextVar(index);
+
+      next->RemoveValues(routeEnds);
+
+      // Unperformed reloads point to themselves
+      for (const auto other : reloadIndices)
+        if (other != index)
+          next->RemoveValue(other);
+    }
+  }
+
+  // Shifts bind only if they cut into [0, timeHorizon], limit route durations below it or cost something
+  bool needsVehicleShifts() const {
+    for (const auto& shift : config->vehicleShifts.windows)
+      if (shift.start > 0 || shift.stop < timeHorizon)
+        return true;
+
+    return config->vehicleShifts.maxRouteDuration < timeHorizon || config->vehicleShifts.spanCost > 0;
+  }
+
+  // Initial routes in the model's nodes: depot visits and inner nodes of contracted chains go, heads stand for their chain.
+  // Nullptr without initial routes or if they do not make a solution.
+  const ort::Assignment* readInitialRoutes(RoutingModel& model) const {
+    if (config->initialRoutes.empty())
+      return nullptr;
+
+    std::vector<std::vector<NodeIndex>> routes(config->initialRoutes.size());
+
+    for (std::size_t vehicle = 0; vehicle < config->initialRoutes.size(); ++vehicle) {
+      for (const auto& node : config->initialRoutes[vehicle]) {
+        if (node.value() == vehicleDepot)
+          continue;
+
+        const auto reduced = contraction ? contraction->reduce(node.value()) : node.value();
+
+        if (reduced != -1)
+          routes[vehicle].push_back(NodeIndex{reduced});
+      }
+    }
+
+    // Routes on identical vehicles in the order symmetry breaking expects, otherwise they would not make a solution
+    if (config->symmetryBreaking != SymmetryBreaking::None)
+      orderRoutes(model, identicalVehicles(), routes);
+
+    return model.ReadAssignmentFromRoutes(routes, /*ignore_inactive_nodes=*/true);
+  }
+
+  // Groups of vehicles no constraint tells apart; all vehicles share the depot and the arc costs already.
+  // Vehicles with locked routes are told apart by their locks.
+  std::vector<std::vector<std::int32_t>> identicalVehicles() const {
+    std::vector<std::vector<int64>> signatures(numVehicles);
+
+    for (std::int32_t vehicle = 0; vehicle < numVehicles; ++vehicle) {
+      auto& signature = signatures[vehicle];
+
+      if (!config->routeLocks[vehicle].empty()) {
+        signature = {1, vehicle};
+        continue;
+      }
+
+      signature.push_back(0);
+
+      if (!config->vehicleCapacities.empty())
+        signature.push_back(config->vehicleCapacities[vehicle]);
+
+      for (const auto& resource : *resources)
+        signature.push_back(config->resourceCapacities.at(resource.name)[vehicle]);
+
+      if (!config->vehicleShifts.windows.empty()) {
+        signature.push_back(config->vehicleShifts.windows[vehicle].start);
+        signature.push_back(config->vehicleShifts.windows[vehicle].stop);
+      }
+
+      if (!config->maxRouteLengths.empty())
+        signature.push_back(config->maxRouteLengths[vehicle]);
+
+      for (std::int32_t node = 0; node < config->allowedVehicles.size(); ++node) {
+        if (config->allowedVehicles.restricted(node)) {
+          const auto allowed = config->allowedVehicles.at(node);
+          signature.push_back(std::find(allowed.begin(), allowed.end(), vehicle) != allowed.end());
+        }
+      }
+    }
+
+    return groupIdenticalVehicles(signatures);
+  }
+
+  // On the calling thread's CPU clock, see CpuTimeLimit
+  std::chrono::nanoseconds cpuTimeDeadline() const { return threadCpuTime() + std::chrono::milliseconds(config->cpuTimeLimit); }
+
+  // Scheduled searches spend their time limit on run time only, see ScheduledLimit
+  RoutingSearchParameters makeScheduledParams() const {
+    auto params = searchParams;
+    params.set_time_limit_ms(std::numeric_limits<std::int32_t>::max());
+    return params;
+  }
+
+  // Without windows cutting into [0, timeHorizon] the time dimension can only bind through the horizon.
+  // Every node is left at most once, by its longest arc at worst: if that fits the horizon so does any route.
+  bool needsTimeDimension() const {
+    if (!timeDependentDurations->empty())
+      return true;
+
+    // Pair precedence goes through the time cumuls unless the paths constraint takes care of it
+    if (config->pickupDeliveryPolicy.mode == PickupDeliveryMode::Constraints && config->pickups.size() > 0)
+      return true;
+
+    for (std::int32_t node = 0; node < timeWindows->size(); ++node)
+      if (timeWindows->at(node).start > 0 || timeWindows->at(node).stop < timeHorizon)
+        return true;
+
+    for (std::int32_t node = 0; node < config->softTimeWindows.size(); ++node)
+      if (config->softTimeWindows.at(node).penalized())
+        return true;
+
+    if (needsVehicleShifts())
+      return true;
+
+    std::int64_t longestRoute = 0;
+
+    for (std::int32_t from = 0; from < durations->dim(); ++from) {
+      std::int32_t longestArc = 0;
+
+      for (std::int32_t to = 0; to < durations->dim(); ++to)
+        longestArc = std::max(longestArc, durations->at(from, to));
+
+      longestRoute += longestArc;
+
+      // Reloads are left like the depot
+      if (from == vehicleDepot)
+        longestRoute += static_cast<std::int64_t>(config->reloads) * longestArc;
+    }
+
+    return longestRoute > timeHorizon;
+  }
+
+  // Same bound for demands; negative demands rely on the dimension keeping loads non-negative
+  bool needsCapacityDimension() const {
+    if (demands->dim() == 0)
+      return false;
+
+    if (config->vehicleCapacities.empty())
+      return true;
+
+    std::int64_t largestLoad = 0;
+
+    for (std::int32_t from = 0; from < demands->dim(); ++from) {
+      std::int32_t largestDemand = 0;
+
+      for (std::int32_t to = 0; to < demands->dim(); ++to) {
+        if (demands->at(from, to) < 0)
+          return true;
+
+        largestDemand = std::max(largestDemand, demands->at(from, to));
+      }
+
+      largestLoad += largestDemand;
+    }
+
+    return largestLoad > *std::min_element(config->vehicleCapacities.begin(), config->vehicleCapacities.end());
+  }
+
+  // Arrival times along a route when nothing constrains them: as early as possible, as late as the horizon allows
+  std::vector<Interval> makeUnconstrainedRouteTimes(const std::vector<NodeIndex>& route) const {
+    auto depotFor = [&](std::int32_t node) { return node >= numNodes ? vehicleDepot : node; };
+    auto duration = [&](std::int32_t from, std::int32_t to) {
+      return durations->dim() == 0 ? 0 : durations->at(depotFor(from), depotFor(to));
+    };
+
+    std::vector<std::int64_t> arrivals(route.size());
+    std::vector<std::int64_t> remaining(route.size());
+
+    std::int64_t arrival = 0;
+    auto previous = vehicleDepot;
+
+    for (std::size_t atIdx = 0; atIdx < route.size(); ++atIdx) {
+      arrival += duration(previous, route[atIdx].value());
+      arrivals[atIdx] = arrival;
+      previous = route[atIdx].value();
+    }
+
+    std::int64_t left = 0;
+    auto next = vehicleDepot;
+
+    for (std::size_t atIdx = route.size(); atIdx > 0; --atIdx) {
+      left += duration(route[atIdx - 1].value(), next);
+      remaining[atIdx - 1] = left;
+      next = route[atIdx - 1].value();
+    }
+
+    std::vector<Interval> routeTimes;
+
+    for (std::size_t atIdx = 0; atIdx < route.size(); ++atIdx) {
+      const auto first = static_cast<std::int32_t>(arrivals[atIdx]);
+      const auto last = static_cast<std::int32_t>(timeHorizon - remaining[atIdx]);
+
+      routeTimes.push_back(Interval{first, last});
+    }
+
+    return routeTimes;
   }
 
   // Shared ownership: keeps objects alive until the last callback is done.
@@ -267,22 +1216,33 @@ struct VRPWorker final : Nan::AsyncWorker {
   std::shared_ptr<const DurationMatrix> durations;
   std::shared_ptr<const TimeWindows> timeWindows;
   std::shared_ptr<const DemandMatrix> demands;
+  std::shared_ptr<const TimeDependentDurations> timeDependentDurations;
+  std::shared_ptr<const Resources> resources;
+  std::shared_ptr<const DistanceMatrix> distances;
+
+  // Replaced by a reduced copy when contracting locks, see contractLockedChains
+  std::shared_ptr<const VRPSearchParams> config;
 
   std::int32_t numNodes;
-  std::int32_t numVehicles;
+  const std::int32_t numVehicles;
   std::int32_t vehicleDepot;
-  std::int32_t timeHorizon;
-  std::vector<int64> vehicleCapacities;
-
-  const RouteLocks routeLocks;
+  const std::int32_t timeHorizon;
 
-  const Pickups pickups;
-  const Deliveries deliveries;
+  // Set when locked chains got contracted, for expanding solutions
+  std::unique_ptr<ChainContraction> contraction;
 
-  RoutingModel model;
   RoutingModelParameters modelParams;
   RoutingSearchParameters searchParams;
 
+  // Deadline for the scheduler is submission plus time limit
+  const Scheduler::Clock::time_point submitted;
+
+  // Decided on submission: scheduled solves run on the scheduler's threads, see queueWorker
+  bool scheduled;
+
+  // Set when identical solves may join this one, see VRP::Solve
+  std::shared_ptr<VRPFlight> flight;
+
   // Stores solution until we can translate back to v8 objects
   RoutingSolution solution;
 };
@@ -0,0 +1,19 @@
+var tap = require('tap');
+var path = require('path');
+var fs = require('fs');
+var childProcess = require('child_process');
+
+
+// Codec round-trips run natively: the compressed_tiles_test target in binding.gyp.
+// Prebuilt binaries come without it, the test only runs when building from source.
+
+var binary = path.join(__dirname, '..', 'build', 'Release', 'compressed_tiles_test');
+
+
+tap.test('Test compressed tiles round-trip', {skip: !fs.existsSync(binary) && 'built from source only'}, function(assert) {
+  childProcess.execFile(binary, function(err, stdout, stderr) {
+    assert.error(err, stderr);
+    assert.equal(stdout.trim(), 'ok', 'All values read back');
+    assert.end();
+  });
+});
@@ -0,0 +1,127 @@
+// Round-trip checks for the compressed tiles codec, see src/compressed_tiles.h.
+// Built by the compressed_tiles_test target in binding.gyp and run from test/compressed_tiles.js.
+
+#include "compressed_tiles.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+int failures = 0;
+
+void check(bool ok, const std::string& what) {
+  if (!ok) {
+    std::cerr << "not ok: " << what << std::endl;
+    failures += 1;
+  }
+}
+
+// Compresses data and reads every value back, once in random order and once decompressed as a whole
+template <typename T> void roundTrip(const std::string& name, std::int32_t n, const std::vector<T>& data) {
+  const CompressedTiles<T> tiles{n, data};
+
+  check(tiles.dim() == n, name + ": dimension");
+  check(tiles.decompress() == data, name + ": decompress");
+
+  std::vector<std::int32_t> order(data.size());
+
+  for (std::size_t i = 0; i < order.size(); ++i)
+    order[i] = static_cast<std::int32_t>(i);
+
+  std::shuffle(begin(order), end(order), std::mt19937{static_cast<std::uint32_t>(n)});
+
+  for (const auto i : order)
+    if (tiles.at(i % n, i / n) != data[i])
+      return check(false, name + ": value at " + std::to_string(i % n) + ", " + std::to_string(i / n));
+}
+
+template <typename T> std::vector<T> makeUniform(std::int32_t n, T lo, T hi, std::uint32_t seed) {
+  std::mt19937 engine{seed};
+  std::uniform_int_distribution<std::int64_t> values{lo, hi};
+
+  std::vector<T> data(static_cast<std::size_t>(n) * n);
+
+  for (auto& value : data)
+    value = static_cast<T>(values(engine));
+
+  return data;
+}
+
+} // namespace
+
+int main() {
+  using Limits = std::numeric_limits<std::int32_t>;
+
+  // Full 64 x 64 tiles only, and partial edge tiles: 130 = 2 * 64 + 2 columns and rows
+  roundTrip("full tiles", 128, makeUniform<std::int32_t>(128, 0, 1000, 1));
+  roundTrip("partial edge tiles", 130, makeUniform<std::int32_t>(130, 0, 1000, 2));
+  roundTrip("single partial tile", 5, makeUniform<std::int32_t>(5, -50, 50, 3));
+  roundTrip("single value", 1, std::vector<std::int32_t>{42});
+  roundTrip("empty", 0, std::vector<std::int32_t>{});
+
+  // Width 0: constant tiles store no words at all
+  {
+    const std::vector<std::int32_t> data(130 * 130, 7);
+    roundTrip("width 0", 130, data);
+    check(CompressedTiles<std::int32_t>{130, data}.bytes() < 1024, "width 0: no words stored");
+  }
+
+  // Widths not dividing 64 and the full 32 bit range: values span two words
+  roundTrip("width 7 spans", 130, makeUniform<std::int32_t>(130, 100, 227, 4));
+  roundTrip("width 31 spans", 130, makeUniform<std::int32_t>(130, 0, Limits::max(), 5));
+  roundTrip("width 32 spans", 130, makeUniform<std::int32_t>(130, Limits::min(), Limits::max(), 6));
+  roundTrip("width 16 unsigned", 100, makeUniform<std::uint16_t>(100, 0, 65535, 7));
+
+  // Tiles of different widths next to each other: constant top left tile, full range bottom right tile
+  {
+    auto data = makeUniform<std::int32_t>(130, Limits::min(), Limits::max(), 8);
+
+    for (std::int32_t y = 0; y < 64; ++y)
+      for (std::int32_t x = 0; x < 64; ++x)
+        data[y * 130 + x] = -1;
+
+    roundTrip("mixed widths", 130, data);
+  }
+
+  // Out of range lookups throw instead of reading another tile
+  {
+    const CompressedTiles<std::int32_t> tiles{3, std::vector<std::int32_t>(9, 1)};
+
+    auto throws = [&](std::int32_t x, std::int32_t y) {
+      try {
+        tiles.at(x, y);
+      } catch (const std::out_of_range&) {
+        return true;
+      }
+      return false;
+    };
+
+    check(throws(3, 0) && throws(0, 3) && throws(-1, 0) && throws(0, -1), "out of range");
+  }
+
+  // Dimension not matching the data size
+  {
+    bool threw = false;
+
+    try {
+      CompressedTiles<std::int32_t>{3, std::vector<std::int32_t>(8, 1)};
+    } catch (const std::runtime_error&) {
+      threw = true;
+    }
+
+    check(threw, "dimension mismatch");
+  }
+
+  if (failures == 0)
+    std::cout << "ok" << std::endl;
+
+  return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -56,3 +56,111 @@ tap.test('Test TSP', function(assert) {
   });
 
 });
+
+
+tap.test('Test TSP with compressed matrices', function(assert) {
+
+  var solverOpts = {
+    numNodes: locations.length,
+    costs: costMatrix,
+    compressMatrices: true
+  };
+
+  var TSP = new ortools.TSP(solverOpts);
+
+  var searchOpts = {
+    computeTimeLimit: 1000,
+    depotNode: depot
+  };
+
+  TSP.Solve(searchOpts, function (err, solution) {
+    assert.ifError(err, 'Solution can be found');
+
+    function adjacentCost(acc, v) { return { cost: acc.cost + costMatrix[acc.at][v], at: v }; }
+    var route = solution.reduce(adjacentCost, { cost: 0, at: depot });
+    assert.equal(route.cost, locations.length - 1, 'Costs are minimum Manhattan Distance in location grid');
+
+    assert.end();
+  });
+
+});
+
+
+tap.test('Test TSP with a CPU time limit', function(assert) {
+
+  // Points on a 100 x 100 grid from a Park-Miller generator: enough locations for local search to take a while
+  var state = 7;
+  function rand() { state = (state * 48271) % 2147483647; return state % 100; }
+
+  var points = [];
+
+  for (var atIdx = 0; atIdx < 200; ++atIdx)
+    points.push([rand(), rand()]);
+
+  var pointCosts = points.map(function(from) {
+    return points.map(function(to) { return manhattanDistance(from, to); });
+  });
+
+  var TSP = new ortools.TSP({numNodes: points.length, costs: pointCosts});
+
+  var searchOpts = {
+    computeTimeLimit: 10000,
+    cpuTimeLimit: 300,
+    depotNode: depot
+  };
+
+  TSP.Solve(searchOpts, function (err, solution) {
+    assert.ifError(err, 'Solution can be found');
+
+    assert.equal(solution.length, points.length - 1, 'Number of locations in route is number of locations without depot');
+
+    assert.type(solution.stats.wallTime, 'number', 'Stats hold the time spent searching');
+    assert.type(solution.stats.cpuTime, 'number', 'Stats hold the CPU time spent searching');
+    assert.ok(solution.stats.cpuTime < 1000, 'Search stops on its CPU time limit');
+    assert.ok(solution.stats.wallTime < searchOpts.computeTimeLimit, 'Well before the wall time limit');
+    assert.equal(solution.stats.budget, searchOpts.computeTimeLimit, 'Full budget without the scheduler');
+
+    assert.end();
+  });
+
+});
+
+
+tap.test('Test TSP with shrinking budgets under overload', function(assert) {
+
+  var TSP = new ortools.TSP({numNodes: locations.length, costs: costMatrix});
+
+  var computeTimeLimit = 400;
+  var budgetFloor = 0.25;
+
+  var searchOpts = {
+    computeTimeLimit: computeTimeLimit,
+    depotNode: depot
+  };
+
+  ortools.configureScheduler({cores: 1, budgetFloor: budgetFloor});
+
+  var numSolves = 4;
+  var budgets = [];
+
+  for (var i = 0; i < numSolves; ++i) {
+    TSP.Solve(searchOpts, function(err, solution) {
+      assert.ifError(err, 'Solution can be found');
+
+      budgets.push(solution.stats.budget);
+
+      if (budgets.length < numSolves)
+        return;
+
+      assert.ok(budgets.every(function(budget) {
+        return budget >= budgetFloor * computeTimeLimit && budget <= computeTimeLimit;
+      }), 'Budgets between the floor and the time limit');
+
+      assert.ok(budgets.some(function(budget) { return budget < computeTimeLimit; }), 'Budgets shrink under overload');
+
+      ortools.configureScheduler({cores: 0});
+      assert.end();
+    });
+  }
+
+});
@@ -173,3 +173,1237 @@ tap.test('Test VRP', function(assert) {
     assert.end();
   });
 });
+
+
+// Ten vehicles of capacity ten for the day, without locks, pickups and deliveries; `extra` adds or overrides options
+function makeSearchOpts(extra) {
+  return Object.assign({
+    computeTimeLimit: 1000,
+    numVehicles: 10,
+    depotNode: depot,
+    timeHorizon: dayEnds - dayStarts,
+    vehicleCapacities: [10, 10, 10, 10, 10, 10, 10, 10, 10, 10],
+    routeLocks: [[], [], [], [], [], [], [], [], [], []],
+    pickups: [],
+    deliveries: []
+  }, extra);
+}
+
+
+// Binary instance of the grid, see VRP.fromStream
+function makeInstanceBuffer() {
+  var numNodes = locations.length;
+
+  function writeMatrix(values, offset, matrix) {
+    for (var from = 0; from < numNodes; ++from)
+      for (var to = 0; to < numNodes; ++to, offset += 4)
+        values.writeInt32LE(Math.floor(matrix[from][to]), offset);
+    return offset;
+  }
+
+  var instance = Buffer.alloc(4 * (3 * numNodes * numNodes + 2 * numNodes));
+
+  var offset = writeMatrix(instance, 0, costMatrix);
+  offset = writeMatrix(instance, offset, durationMatrix);
+
+  for (var at = 0; at < numNodes; ++at, offset += 8) {
+    instance.writeInt32LE(Math.floor(timeWindows[at][0]), offset);
+    instance.writeInt32LE(Math.floor(timeWindows[at][1]), offset + 4);
+  }
+
+  writeMatrix(instance, offset, demandMatrix);
+
+  return instance;
+}
+
+
+tap.test('Test VRP from stream', function(assert) {
+  var instance = makeInstanceBuffer();
+
+  // Split into odd-sized chunks to cross value boundaries
+  var chunks = [];
+  for (var begin = 0; begin < instance.length; begin += 37)
+    chunks.push(instance.slice(begin, begin + 37));
+
+  var source = require('stream').Readable.from(chunks);
+  var progress = 0;
+
+  ortools.VRP.fromStream(source, {numNodes: locations.length, onProgress: function(bytes) { progress = bytes; }}, function(err, VRP) {
+    assert.ifError(err, 'Instance can be decoded');
+    assert.equal(progress, instance.length, 'Progress reaches instance size');
+
+    var searchOpts = makeSearchOpts();
+
+    VRP.Solve(searchOpts, function (err, solution) {
+      assert.ifError(err, 'Solution can be found');
+      assert.equal(solution.routes.length, 10, 'Number of routes is number of vehicles');
+      assert.end();
+    });
+  });
+});
+
+
+tap.test('Test VRP from file descriptor', function(assert) {
+  var fs = require('fs');
+  var os = require('os');
+  var path = require('path');
+
+  var file = path.join(fs.mkdtempSync(path.join(os.tmpdir(), 'node-or-tools-')), 'instance.bin');
+  fs.writeFileSync(file, makeInstanceBuffer());
+
+  var fd = fs.openSync(file, 'r');
+
+  // Decoded on a worker thread
+  ortools.VRP.fromStream(fd, {numNodes: locations.length}, function(err, VRP) {
+    fs.closeSync(fd);
+    fs.unlinkSync(file);
+    fs.rmdirSync(path.dirname(file));
+
+    assert.ifError(err, 'Instance can be decoded');
+
+    var searchOpts = makeSearchOpts();
+
+    VRP.Solve(searchOpts, function (err, solution) {
+      assert.ifError(err, 'Solution can be found');
+      assert.equal(solution.routes.length, 10, 'Number of routes is number of vehicles');
+      assert.end();
+    });
+  });
+});
+
+
+tap.test('Test VRP from a failing stream', function(assert) {
+  var source = new (require('stream').PassThrough)();
+
+  ortools.VRP.fromStream(source, {numNodes: locations.length}, function(err, VRP) {
+    assert.ok(err, 'Errors reach the callback');
+    assert.notOk(VRP, 'No solver object on errors');
+    assert.ok(source.destroyed, 'Source stops reading on errors');
+    assert.end();
+  });
+
+  source.write(makeInstanceBuffer().slice(0, 64));
+  source.emit('error', new Error('Connection reset'));
+});
+
+
+tap.test('Test VRP with time-dependent durations', function(assert) {
+
+  // Rush hour in the first hour: everything takes twice as long
+  var rushHourMatrix = durationMatrix.map(function(row) { return row.map(function(v) { return 2 * v; }); });
+
+  var solverOpts = {
+    numNodes: locations.length,
+    costs: costMatrix,
+    durations: {
+      departures: [Hours(0), Hours(1)],
+      matrices: [rushHourMatrix, durationMatrix],
+      interpolation: 'step'
+    },
+    timeWindows: timeWindows,
+    demands: demandMatrix
+  };
+
+  var VRP = new ortools.VRP(solverOpts);
+
+  var searchOpts = makeSearchOpts();
+
+  function arrivalAt(departure, from, to) {
+    var matrix = departure < Hours(1) ? rushHourMatrix : durationMatrix;
+    return Math.min(departure + matrix[from][to], Math.max(departure, Hours(1)) + durationMatrix[from][to]);
+  }
+
+  VRP.Solve(searchOpts, function (err, solution) {
+    assert.ifError(err, 'Solution can be found');
+
+    solution.routes.forEach(function(route, vehicle) {
+      var times = solution.times[vehicle];
+
+      for (var i = 1; i < route.length; ++i) {
+        assert.ok(times[i][0] >= arrivalAt(times[i - 1][0], route[i - 1], route[i]), 'Arrival respects departure-dependent duration');
+        assert.ok(times[i][1] >= arrivalAt(times[i - 1][1], route[i - 1], route[i]), 'Latest departure still arrives in time');
+      }
+    });
+
+    assert.end();
+  });
+});
+
+
+tap.test('Test VRP with multiple resources', function(assert) {
+
+  var weights = locations.map(function(_, at) { return at === depot ? 0 : 2; });
+  var volumes = locations.map(function(_, at) { return at === depot ? 0 : 1; });
+
+  var solverOpts = {
+    numNodes: locations.length,
+    costs: costMatrix,
+    durations: durationMatrix,
+    timeWindows: timeWindows,
+    demands: demandMatrix,
+    resources: {weight: weights, volume: volumes}
+  };
+
+  var VRP = new ortools.VRP(solverOpts);
+
+  var searchOpts = makeSearchOpts({
+    resourceCapacities: {
+      weight: [6, 6, 6, 6, 6, 6, 6, 6, 6, 6],
+      volume: [10, 10, 10, 10, 10, 10, 10, 10, 10, 10]
+    }
+  });
+
+  VRP.Solve(searchOpts, function (err, solution) {
+    assert.ifError(err, 'Solution can be found');
+
+    solution.routes.forEach(function(route) {
+      var weight = route.reduce(function(acc, at) { return acc + weights[at]; }, 0);
+      assert.ok(weight <= 6, 'Route weight within vehicle capacity');
+    });
+
+    var strayOpts = Object.assign({}, searchOpts, {resourceCapacities: Object.assign({height: [1]}, searchOpts.resourceCapacities)});
+
+    assert.throws(function() { VRP.Solve(strayOpts, function() {}); }, 'Capacities for unknown resources throw');
+
+    assert.end();
+  });
+});
+
+
+tap.test('Test VRP without durations and demands', function(assert) {
+
+  var solverOpts = {
+    numNodes: locations.length,
+    costs: costMatrix
+  };
+
+  var VRP = new ortools.VRP(solverOpts);
+
+  var numVehicles = 3;
+
+  var searchOpts = {
+    computeTimeLimit: 1000,
+    numVehicles: numVehicles,
+    depotNode: depot,
+    routeLocks: [[], [], []],
+    pickups: [],
+    deliveries: []
+  };
+
+  VRP.Solve(searchOpts, function (err, solution) {
+    assert.ifError(err, 'Solution can be found');
+
+    assert.equal(solution.routes.length, numVehicles, 'Number of routes is number of vehicles');
+
+    var visited = solution.routes.reduce(function(acc, route) { return acc + route.length; }, 0);
+    assert.equal(visited, locations.length - 1, 'All locations but the depot are visited');
+
+    solution.times.forEach(function(route) {
+      route.forEach(function(interval) { assert.equal(interval[0], 0, 'Arrival without durations is immediate'); });
+    });
+
+    assert.end();
+  });
+});
+
+
+tap.test('Test VRP with pickups and deliveries in lifo order', function(assert) {
+
+  var solverOpts = {
+    numNodes: locations.length,
+    costs: costMatrix
+  };
+
+  var VRP = new ortools.VRP(solverOpts);
+
+  var numVehicles = 10;
+  var pickups = [4, 12, 5];
+  var deliveries = [9, 8, 6];
+
+  var searchOpts = {
+    computeTimeLimit: 1000,
+    numVehicles: numVehicles,
+    depotNode: depot,
+    routeLocks: [[], [], [], [], [], [], [], [], [], []],
+    pickups: pickups,
+    deliveries: deliveries,
+    pickupDeliveryMode: 'paths',
+    pickupDeliveryOrder: 'lifo'
+  };
+
+  VRP.Solve(searchOpts, function (err, solution) {
+    assert.ifError(err, 'Solution can be found');
+
+    assert.type(solution.stats.solutions, 'number', 'Stats hold the number of solutions');
+    assert.type(solution.stats.wallTime, 'number', 'Stats hold the time spent searching');
+
+    solution.routes.forEach(function(route) {
+      var onBoard = [];
+
+      route.forEach(function(node) {
+        if (pickups.indexOf(node) !== -1)
+          onBoard.push(node);
+
+        var pair = deliveries.indexOf(node);
+
+        if (pair !== -1)
+          assert.equal(onBoard.pop(), pickups[pair], 'Delivery unloads the last pickup on the same route');
+      });
+
+      assert.equal(onBoard.length, 0, 'Route delivers everything it picks up');
+    });
+
+    assert.end();
+  });
+});
+
+
+tap.test('Test VRP with contracted route locks', function(assert) {
+
+  var solverOpts = {
+    numNodes: locations.length,
+    costs: costMatrix,
+    durations: durationMatrix,
+    timeWindows: timeWindows,
+    demands: demandMatrix
+  };
+
+  var VRP = new ortools.VRP(solverOpts);
+
+  var searchOpts = makeSearchOpts({
+    routeLocks: [[2, 3, 7], [], [], [], [], [], [], [], [], []],
+    contractLocks: true
+  });
+
+  VRP.Solve(searchOpts, function (err, solution) {
+    assert.ifError(err, 'Solution can be found');
+
+    var visited = solution.routes.reduce(function(acc, route) { return acc + route.length; }, 0);
+    assert.equal(visited, locations.length - 1, 'All locations but the depot are visited');
+
+    assert.deepEqual(solution.routes[0].slice(0, 3), [2, 3, 7], 'Locked chain is expanded in order');
+    assert.equal(solution.times[0].length, solution.routes[0].length, 'Times per location in route');
+    assert.equal(solution.costDetails[0].length, solution.routes[0].length + 1, 'Costs per arc in route');
+
+    assert.end();
+  });
+});
+
+
+tap.test('Test VRP with overlapping contracted route locks', function(assert) {
+
+  var solverOpts = {
+    numNodes: locations.length,
+    costs: costMatrix,
+    durations: durationMatrix,
+    timeWindows: timeWindows,
+    demands: demandMatrix
+  };
+
+  var VRP = new ortools.VRP(solverOpts);
+
+  var searchOpts = makeSearchOpts({
+    routeLocks: [[1, 2], [2, 3], [], [], [], [], [], [], [], []],
+    contractLocks: true
+  });
+
+  VRP.Solve(searchOpts, function (err, solution) {
+    assert.ok(err, 'Overlapping locks are rejected instead of dropping locations');
+    assert.equal(err.message, 'Invalid locks', 'Same error as without contraction');
+    assert.notOk(solution, 'No solution for invalid locks');
+
+    assert.end();
+  });
+});
+
+
+tap.test('Test VRP with reloads', function(assert) {
+
+  var unitDemands = locations.map(function(_, from) {
+    return locations.map(function() { return from === depot ? 0 : 1; });
+  });
+
+  var solverOpts = {
+    numNodes: locations.length,
+    costs: costMatrix,
+    demands: unitDemands
+  };
+
+  var VRP = new ortools.VRP(solverOpts);
+
+  var searchOpts = {
+    computeTimeLimit: 1000,
+    numVehicles: 1,
+    depotNode: depot,
+    vehicleCapacities: [5],
+    routeLocks: [[]],
+    pickups: [],
+    deliveries: [],
+    reloads: 3
+  };
+
+  VRP.Solve(searchOpts, function (err, solution) {
+    assert.ifError(err, 'Solution can be found');
+
+    var route = solution.routes[0];
+    var stops = route.filter(function(node) { return node !== depot; });
+
+    assert.equal(stops.length, locations.length - 1, 'All locations but the depot are visited');
+    assert.ok(route.length - stops.length >= 2, 'Vehicle reloads at the depot between trips');
+
+    var load = 0;
+
+    route.forEach(function(node) {
+      load = node === depot ? 0 : load + 1;
+      assert.ok(load <= 5, 'Load stays within capacity between reloads');
+    });
+
+    assert.end();
+  });
+});
+
+
+tap.test('Test VRP with allowed vehicles', function(assert) {
+
+  var solverOpts = {
+    numNodes: locations.length,
+    costs: costMatrix
+  };
+
+  var VRP = new ortools.VRP(solverOpts);
+
+  // Only vehicle 1 may serve the last row, everything else is up for grabs
+  var allowedVehicles = locations.map(function(location) { return location[0] === 3 ? [1] : null; });
+
+  var searchOpts = {
+    computeTimeLimit: 1000,
+    numVehicles: 3,
+    depotNode: depot,
+    routeLocks: [[], [], []],
+    pickups: [],
+    deliveries: [],
+    allowedVehicles: allowedVehicles
+  };
+
+  VRP.Solve(searchOpts, function (err, solution) {
+    assert.ifError(err, 'Solution can be found');
+
+    solution.routes.forEach(function(route, vehicle) {
+      route.forEach(function(node) {
+        if (allowedVehicles[node] !== null)
+          assert.ok(allowedVehicles[node].indexOf(vehicle) !== -1, 'Location is served by an allowed vehicle');
+      });
+    });
+
+    assert.end();
+  });
+});
+
+
+tap.test('Test VRP with soft time windows', function(assert) {
+
+  var solverOpts = {
+    numNodes: locations.length,
+    costs: costMatrix,
+    durations: durationMatrix
+  };
+
+  var VRP = new ortools.VRP(solverOpts);
+
+  // Everyone wants to be served within the first few minutes: impossible with hard windows, late for most
+  var softTimeWindows = locations.map(function(_, node) {
+    return node === depot ? null : [0, Minutes(5), 0, 1];
+  });
+
+  var searchOpts = {
+    computeTimeLimit: 1000,
+    numVehicles: 2,
+    depotNode: depot,
+    timeHorizon: dayEnds - dayStarts,
+    routeLocks: [[], []],
+    pickups: [],
+    deliveries: [],
+    softTimeWindows: softTimeWindows
+  };
+
+  VRP.Solve(searchOpts, function (err, solution) {
+    assert.ifError(err, 'Solution can be found');
+
+    var visited = solution.routes.reduce(function(acc, route) { return acc + route.length; }, 0);
+    assert.equal(visited, locations.length - 1, 'All locations but the depot are visited');
+
+    var arcCosts = solution.costDetails.reduce(function(acc, costs) {
+      return acc + costs.reduce(function(sum, cost) { return sum + cost; }, 0);
+    }, 0);
+
+    assert.ok(solution.cost > arcCosts, 'Lateness is penalized on top of arc costs');
+
+    assert.end();
+  });
+});
+
+
+tap.test('Test VRP with vehicle shifts', function(assert) {
+
+  var solverOpts = {
+    numNodes: locations.length,
+    costs: costMatrix,
+    durations: durationMatrix
+  };
+
+  var VRP = new ortools.VRP(solverOpts);
+
+  var searchOpts = {
+    computeTimeLimit: 1000,
+    numVehicles: 3,
+    depotNode: depot,
+    timeHorizon: dayEnds - dayStarts,
+    routeLocks: [[], [], []],
+    pickups: [],
+    deliveries: [],
+    vehicleShifts: [[Hours(1), Hours(3)], null, null],
+    maxRouteDuration: Minutes(40),
+    spanCost: 1
+  };
+
+  // Without time windows routes never wait: a route takes the durations along it, from the depot back to the depot
+  function routeDuration(route) {
+    var stops = [depot].concat(route, [depot]);
+    var duration = 0;
+
+    for (var i = 1; i < stops.length; ++i)
+      duration += durationMatrix[stops[i - 1]][stops[i]];
+
+    return duration;
+  }
+
+  // Leaving a location takes at least its shortest duration: a single vehicle can not serve all of them in time
+  var allInOne = durationMatrix.reduce(function(acc, row, from) {
+    var shortest = Math.min.apply(null, row.filter(function(_, to) { return to !== from; }));
+    return from === depot ? acc : acc + shortest;
+  }, 0);
+
+  assert.ok(allInOne > searchOpts.maxRouteDuration, 'Route duration limit binds');
+
+  VRP.Solve(searchOpts, function (err, solution) {
+    assert.ifError(err, 'Solution can be found');
+
+    var visited = solution.routes.reduce(function(acc, route) { return acc + route.length; }, 0);
+    assert.equal(visited, locations.length - 1, 'All locations but the depot are visited');
+
+    solution.times[0].forEach(function(time) {
+      assert.ok(time[0] >= Hours(1) && time[1] <= Hours(3), 'First vehicle serves locations within its shift');
+    });
+
+    var used = solution.routes.filter(function(route) { return route.length > 0; }).length;
+    assert.ok(used >= 2, 'Route duration limit splits the locations across vehicles');
+
+    solution.routes.forEach(function(route) {
+      if (route.length > 0)
+        assert.ok(routeDuration(route) <= searchOpts.maxRouteDuration, 'Routes are within the route duration limit');
+    });
+
+    assert.end();
+  });
+});
+
+
+tap.test('Test VRP with route length limits', function(assert) {
+
+  var solverOpts = {
+    numNodes: locations.length,
+    costs: costMatrix
+  };
+
+  var VRP = new ortools.VRP(solverOpts);
+
+  var maxRouteLengths = [12, 12, 12, 12];
+
+  var searchOpts = {
+    computeTimeLimit: 1000,
+    numVehicles: maxRouteLengths.length,
+    depotNode: depot,
+    routeLocks: [[], [], [], []],
+    pickups: [],
+    deliveries: [],
+    maxRouteLengths: maxRouteLengths
+  };
+
+  VRP.Solve(searchOpts, function (err, solution) {
+    assert.ifError(err, 'Solution can be found');
+
+    solution.routes.forEach(function(route, vehicle) {
+      var previous = depot;
+      var length = 0;
+
+      route.concat([depot]).forEach(function(node) {
+        length += costMatrix[previous][node];
+        previous = node;
+      });
+
+      assert.ok(length <= maxRouteLengths[vehicle], 'Route stays within the vehicle\'s range');
+    });
+
+    assert.end();
+  });
+});
+
+
+tap.test('Test VRP with the construction engine', function(assert) {
+
+  var solverOpts = {
+    numNodes: locations.length,
+    costs: costMatrix,
+    durations: durationMatrix,
+    timeWindows: timeWindows,
+    demands: demandMatrix
+  };
+
+  var VRP = new ortools.VRP(solverOpts);
+
+  var numVehicles = 10;
+
+  var searchOpts = makeSearchOpts({computeTimeLimit: 20, engine: 'construct'});
+
+  VRP.Solve(searchOpts, function (err, solution) {
+    assert.ifError(err, 'Solution can be found');
+
+    assert.equal(solution.routes.length, numVehicles, 'Number of routes');
+    assert.equal(solution.times.length, numVehicles, 'Number of time routes');
+    assert.equal(solution.costDetails.length, numVehicles, 'Number of cost routes');
+
+    var visited = solution.routes.reduce(function(acc, route) { return acc + route.length; }, 0);
+    assert.equal(visited, locations.length - 1, 'All locations but the depot are visited');
+
+    var arcCosts = solution.costDetails.reduce(function(acc, costs) {
+      return acc + costs.reduce(function(sum, cost) { return sum + cost; }, 0);
+    }, 0);
+
+    assert.equal(solution.cost, arcCosts, 'Cost is the sum of arc costs');
+
+    assert.end();
+  });
+});
+
+
+tap.test('Test VRP with the construction engine on a few hundred locations', function(assert) {
+  var generated = ortools.VRP.generate({
+    numNodes: 300,
+    numVehicles: 38,
+    windowTightness: 0.3,
+    capacityTightness: 0.5,
+    seed: 88
+  });
+
+  // The polish stops within its time limit; a single pass walking candidate routes took seconds here
+  var searchOpts = Object.assign({computeTimeLimit: 20, engine: 'construct'}, generated.searchOptions);
+
+  generated.vrp.Solve(searchOpts, function (err, solution) {
+    assert.ifError(err, 'Solution can be found');
+
+    var visited = solution.routes.reduce(function(acc, route) { return acc + route.length; }, 0);
+    assert.equal(visited, 299, 'All locations but the depot are visited');
+
+    assert.ok(solution.stats.wallTime < 200, 'Polishing stops on the time limit');
+
+    assert.end();
+  });
+});
+
+
+tap.test('Test VRP with the construction engine on a few thousand locations', function(assert) {
+  var generated = ortools.VRP.generate({
+    numNodes: 2000,
+    numVehicles: 250,
+    windowTightness: 0.3,
+    capacityTightness: 0.5,
+    seed: 88
+  });
+
+  // Savings from nearest neighbours only: no sorting of millions of savings before the deadline gets checked
+  var searchOpts = Object.assign({computeTimeLimit: 1000, engine: 'construct'}, generated.searchOptions);
+
+  generated.vrp.Solve(searchOpts, function (err, solution) {
+    assert.ifError(err, 'Solution can be found');
+
+    var visited = solution.routes.reduce(function(acc, route) { return acc + route.length; }, 0);
+    assert.equal(visited, 1999, 'All locations but the depot are visited');
+
+    assert.ok(solution.stats.wallTime < 1500, 'Construction and polishing stop on the time limit');
+
+    // Too little time to build a plan: fails on the time limit instead of running past it
+    var previewOpts = Object.assign({}, searchOpts, {computeTimeLimit: 5});
+    var started = Date.now();
+
+    generated.vrp.Solve(previewOpts, function () {
+      assert.ok(Date.now() - started < 200, 'Construction stops on the time limit');
+      assert.end();
+    });
+  });
+});
+
+
+tap.test('Test VRP with concurrent first solution strategies', function(assert) {
+
+  var solverOpts = {
+    numNodes: locations.length,
+    costs: costMatrix,
+    durations: durationMatrix,
+    timeWindows: timeWindows,
+    demands: demandMatrix
+  };
+
+  var VRP = new ortools.VRP(solverOpts);
+
+  var searchOpts = makeSearchOpts({
+    firstSolutionStrategies: ['PATH_CHEAPEST_ARC', 'SAVINGS', 'CHRISTOFIDES', 'PARALLEL_CHEAPEST_INSERTION']
+  });
+
+  VRP.Solve(searchOpts, function (err, solution) {
+    assert.ifError(err, 'Solution can be found');
+
+    var visited = solution.routes.reduce(function(acc, route) { return acc + route.length; }, 0);
+    assert.equal(visited, locations.length - 1, 'All locations but the depot are visited');
+
+    assert.end();
+  });
+});
+
+
+tap.test('Test VRP with cooperating islands', function(assert) {
+
+  var solverOpts = {
+    numNodes: locations.length,
+    costs: costMatrix,
+    durations: durationMatrix,
+    timeWindows: timeWindows,
+    demands: demandMatrix
+  };
+
+  var VRP = new ortools.VRP(solverOpts);
+
+  var numIslands = 3;
+
+  var searchOpts = makeSearchOpts({islands: numIslands, islandSyncInterval: 200});
+
+  VRP.Solve(searchOpts, function (err, solution) {
+    assert.ifError(err, 'Solution can be found');
+
+    var visited = solution.routes.reduce(function(acc, route) { return acc + route.length; }, 0);
+    assert.equal(visited, locations.length - 1, 'All locations but the depot are visited');
+
+    assert.equal(solution.stats.islands.length, numIslands, 'Improvements per island');
+
+    var best = Math.min.apply(null, solution.stats.islands.map(function(improvements) {
+      return improvements.length > 0 ? improvements[improvements.length - 1][1] : Infinity;
+    }));
+
+    assert.equal(solution.cost, best, 'Solution is the best across islands');
+
+    var improvements = solution.stats.islands.reduce(function(acc, island) { return acc + island.length; }, 0);
+
+    assert.ok(solution.stats.solutions >= improvements, 'Solutions counted across islands');
+
+    assert.end();
+  });
+});
+
+
+tap.test('Test VRP with the scheduler', function(assert) {
+  var solverOpts = {
+    numNodes: locations.length,
+    costs: costMatrix,
+    durations: durationMatrix,
+    timeWindows: timeWindows,
+    demands: demandMatrix
+  };
+
+  var VRP = new ortools.VRP(solverOpts);
+
+  // One core: the short solve is due first and takes over the core from the long one
+  ortools.configureScheduler({cores: 1, timeSlice: 5});
+
+  var finished = [];
+
+  function done(name) {
+    return function(err, solution) {
+      assert.ifError(err, 'Solution can be found');
+
+      finished.push(name);
+
+      if (name === 'long')
+        assert.ok(solution.stats.waitTime > 0, 'Long solve waited for the short one');
+
+      if (finished.length < 2)
+        return;
+
+      assert.deepEqual(finished, ['short', 'long'], 'Short solve does not queue behind the long one');
+
+      ortools.configureScheduler({cores: 0});
+      assert.end();
+    };
+  }
+
+  VRP.Solve(makeSearchOpts({computeTimeLimit: 2000}), done('long'));
+  VRP.Solve(makeSearchOpts({computeTimeLimit: 200}), done('short'));
+});
+
+
+tap.test('Test VRP scheduler keeping the thread pool free', function(assert) {
+  var solverOpts = {
+    numNodes: locations.length,
+    costs: costMatrix,
+    durations: durationMatrix,
+    timeWindows: timeWindows,
+    demands: demandMatrix
+  };
+
+  var VRP = new ortools.VRP(solverOpts);
+
+  var searchOpts = makeSearchOpts({computeTimeLimit: 300});
+
+  ortools.configureScheduler({cores: 1});
+
+  // More parked solves than Node's thread pool has threads
+  var numSolves = 6;
+  var solved = 0;
+  var statted = false;
+
+  for (var i = 0; i < numSolves; ++i) {
+    VRP.Solve(searchOpts, function(err) {
+      assert.ifError(err, 'Solution can be found');
+
+      if (++solved < numSolves)
+        return;
+
+      assert.ok(statted, 'File system work ran while solves were parked');
+
+      ortools.configureScheduler({cores: 0});
+      assert.end();
+    });
+  }
+
+  require('fs').stat(__filename, function(err) {
+    assert.ifError(err, 'File can be stat\'ed');
+    assert.equal(solved, 0, 'Before the first solve finished');
+    statted = true;
+  });
+});
+
+
+tap.test('Test VRP with coalesced solves', function(assert) {
+  var solverOpts = {
+    numNodes: locations.length,
+    costs: costMatrix,
+    durations: durationMatrix,
+    timeWindows: timeWindows,
+    demands: demandMatrix
+  };
+
+  var searchOpts = makeSearchOpts({computeTimeLimit: 500, coalesce: true});
+
+  // Same options on other data: must not join, even though the search options match
+  var otherCosts = costMatrix.map(function(row) { return row.map(function(v) { return v + 1; }); });
+  var otherOpts = Object.assign({}, solverOpts, {costs: otherCosts});
+
+  // Separate objects on identical data: retries in flight join the first solve
+  var numSolves = 3;
+  var solutions = [];
+  var other = null;
+
+  function done() {
+    if (solutions.length < numSolves || !other)
+      return;
+
+    assert.ok(solutions.every(function(solution) { return solution.cost === solutions[0].cost; }), 'Coalesced solves share the search');
+    assert.same(solutions[1].routes, solutions[0].routes, 'Coalesced solves get the same routes');
+    assert.notEqual(solutions[1], solutions[0], 'Every coalesced solve gets a result object of its own');
+    assert.notEqual(other, solutions[0], 'Solves on other data get a result of their own');
+    assert.end();
+  }
+
+  for (var i = 0; i < numSolves; ++i) {
+    new ortools.VRP(solverOpts).Solve(searchOpts, function(err, solution) {
+      assert.ifError(err, 'Solution can be found');
+
+      solutions.push(solution);
+      done();
+    });
+  }
+
+  new ortools.VRP(otherOpts).Solve(searchOpts, function(err, solution) {
+    assert.ifError(err, 'Solution can be found');
+
+    other = solution;
+    done();
+  });
+});
+
+
+tap.test('Test VRP with coalesced solves mutating their result', function(assert) {
+  var solverOpts = {
+    numNodes: locations.length,
+    costs: costMatrix,
+    durations: durationMatrix,
+    timeWindows: timeWindows,
+    demands: demandMatrix
+  };
+
+  var VRP = new ortools.VRP(solverOpts);
+
+  var searchOpts = makeSearchOpts({computeTimeLimit: 500, coalesce: true});
+
+  var numSolves = 3;
+  var called = 0;
+
+  for (var i = 0; i < numSolves; ++i) {
+    VRP.Solve(searchOpts, function(err, solution) {
+      assert.ifError(err, 'Solution can be found');
+
+      // The leader's callback runs first and scribbles over its result
+      if (called++ === 0) {
+        solution.routes.pop();
+        solution.cost = -1;
+        return;
+      }
+
+      assert.equal(solution.routes.length, searchOpts.numVehicles, 'Followers get routes for all vehicles');
+      assert.ok(solution.cost >= 0, 'Followers get the cost as solved');
+
+      if (called === numSolves)
+        assert.end();
+    });
+  }
+});
+
+
+tap.test('Test VRP with scheduler tenants', function(assert) {
+  var solverOpts = {
+    numNodes: locations.length,
+    costs: costMatrix,
+    durations: durationMatrix,
+    timeWindows: timeWindows,
+    demands: demandMatrix
+  };
+
+  var VRP = new ortools.VRP(solverOpts);
+
+  ortools.configureScheduler({cores: 1, tenants: {noisy: {weight: 1}, quiet: {weight: 1}}});
+
+  var numNoisy = 3;
+  var finished = [];
+
+  function done(tenant) {
+    return function(err) {
+      assert.ifError(err, 'Solution can be found');
+
+      finished.push(tenant);
+
+      if (finished.length < numNoisy + 1)
+        return;
+
+      assert.equal(finished[0], 'quiet', 'Quiet tenant does not queue behind the noisy one');
+
+      var stats = ortools.schedulerStats();
+
+      assert.equal(stats.noisy.completed, numNoisy, 'Noisy solves completed');
+      assert.equal(stats.quiet.completed, 1, 'Quiet solve completed');
+      assert.ok(stats.noisy.runTime > stats.quiet.runTime, 'Noisy tenant ran longer');
+      assert.ok(stats.noisy.latency.p99 >= stats.noisy.latency.p50, 'Latency percentiles');
+
+      ortools.configureScheduler({cores: 0});
+      assert.end();
+    };
+  }
+
+  for (var i = 0; i < numNoisy; ++i)
+    VRP.Solve(makeSearchOpts({computeTimeLimit: 600, tenant: 'noisy'}), done('noisy'));
+
+  VRP.Solve(makeSearchOpts({computeTimeLimit: 200, tenant: 'quiet'}), done('quiet'));
+});
+
+
+tap.test('Test VRP with shrinking budgets under overload', function(assert) {
+  var solverOpts = {
+    numNodes: locations.length,
+    costs: costMatrix,
+    durations: durationMatrix,
+    timeWindows: timeWindows,
+    demands: demandMatrix
+  };
+
+  var VRP = new ortools.VRP(solverOpts);
+
+  var computeTimeLimit = 400;
+  var budgetFloor = 0.25;
+
+  var searchOpts = makeSearchOpts({computeTimeLimit: computeTimeLimit});
+
+  ortools.configureScheduler({cores: 1, budgetFloor: budgetFloor});
+
+  var numSolves = 4;
+  var budgets = [];
+
+  for (var i = 0; i < numSolves; ++i) {
+    VRP.Solve(searchOpts, function(err, solution) {
+      assert.ifError(err, 'Solution can be found');
+
+      budgets.push(solution.stats.budget);
+
+      if (budgets.length < numSolves)
+        return;
+
+      assert.ok(budgets.every(function(budget) {
+        return budget >= budgetFloor * computeTimeLimit && budget <= computeTimeLimit;
+      }), 'Budgets between the floor and the time limit');
+
+      assert.ok(budgets.some(function(budget) { return budget < computeTimeLimit; }), 'Budgets shrink under overload');
+
+      ortools.configureScheduler({cores: 0});
+      assert.end();
+    });
+  }
+});
+
+
+tap.test('Test VRP with a CPU time limit', function(assert) {
+  var solverOpts = {
+    numNodes: locations.length,
+    costs: costMatrix,
+    durations: durationMatrix,
+    timeWindows: timeWindows,
+    demands: demandMatrix
+  };
+
+  var VRP = new ortools.VRP(solverOpts);
+
+  var searchOpts = makeSearchOpts({computeTimeLimit: 10000, cpuTimeLimit: 300});
+
+  VRP.Solve(searchOpts, function (err, solution) {
+    assert.ifError(err, 'Solution can be found');
+
+    assert.ok(solution.stats.cpuTime > 0, 'CPU time reported');
+    assert.ok(solution.stats.cpuTime < 1000, 'Search stops on its CPU time limit');
+    assert.ok(solution.stats.wallTime < searchOpts.computeTimeLimit, 'Well before the wall time limit');
+
+    assert.end();
+  });
+});
+
+
+tap.test('Test VRP portfolio across processes', function(assert) {
+  var instance = {
+    numNodes: locations.length,
+    costs: costMatrix,
+    durations: durationMatrix,
+    timeWindows: timeWindows,
+    demands: demandMatrix
+  };
+
+  var searchOpts = makeSearchOpts();
+
+  ortools.VRP.portfolio(instance, searchOpts, {processes: 2, syncInterval: 200}, function (err, solution) {
+    assert.ifError(err, 'Solution can be found');
+
+    assert.equal(solution.routes.length, searchOpts.numVehicles, 'Number of routes is number of vehicles');
+
+    // Continuing from the portfolio's solution does not make it worse
+    var VRP = new ortools.VRP(instance);
+    var continueOpts = Object.assign({}, searchOpts, {computeTimeLimit: 200, initialRoutes: solution.routes});
+
+    VRP.Solve(continueOpts, function (err, continued) {
+      assert.ifError(err, 'Solution can be found');
+      assert.ok(continued.cost <= solution.cost, 'Search continues from the initial routes');
+      assert.end();
+    });
+  });
+});
+
+
+tap.test('Test VRP portfolio with optional sections left out', function(assert) {
+  var instance = {
+    numNodes: locations.length,
+    costs: costMatrix
+  };
+
+  var searchOpts = {
+    computeTimeLimit: 1000,
+    numVehicles: 3,
+    depotNode: depot,
+    routeLocks: [[], [], []],
+    pickups: [],
+    deliveries: []
+  };
+
+  var resourceInstance = Object.assign({resources: {weight: demandMatrix}}, instance);
+
+  ortools.VRP.portfolio(resourceInstance, searchOpts, {processes: 1}, function (err) {
+    assert.ok(err, 'Sections the processes would not get are rejected');
+
+    ortools.VRP.portfolio(instance, searchOpts, {processes: 2, syncInterval: 200}, function (err, solution) {
+      assert.ifError(err, 'Solution can be found');
+
+      var visited = [].concat.apply([], solution.routes).sort(function(lhs, rhs) { return lhs - rhs; });
+
+      assert.equal(visited.length, locations.length - 1, 'All locations but the depot get visited');
+
+      // Processes got the costs as they are: the reported cost matches the routes' arcs
+      var cost = solution.routes.reduce(function(total, route) {
+        var stops = [depot].concat(route, [depot]);
+
+        for (var at = 1; route.length > 0 && at < stops.length; ++at)
+          total += costMatrix[stops[at - 1]][stops[at]];
+
+        return total;
+      }, 0);
+
+      assert.equal(solution.cost, cost, 'Cost is the sum of the routes\' arc costs');
+      assert.end();
+    });
+  });
+});
+
+
+tap.test('Test VRP portfolio passing on process errors', function(assert) {
+  var instance = {
+    numNodes: locations.length,
+    costs: costMatrix
+  };
+
+  var searchOpts = makeSearchOpts({computeTimeLimit: 1000, reloads: -1});
+
+  ortools.VRP.portfolio(instance, searchOpts, {processes: 2, syncInterval: 200}, function (err, solution) {
+    assert.ok(err, 'Invalid search options fail the portfolio');
+    assert.match(err.message, /reloads/, 'Error from the processes reaches the callback');
+    assert.notOk(solution, 'No solution for invalid search options');
+    assert.end();
+  });
+});
+
+
+tap.test('Test VRP with symmetry breaking on identical vehicles', function(assert) {
+  var solverOpts = {
+    numNodes: locations.length,
+    costs: costMatrix,
+    durations: durationMatrix,
+    timeWindows: timeWindows,
+    demands: demandMatrix
+  };
+
+  var VRP = new ortools.VRP(solverOpts);
+
+  var searchOpts = makeSearchOpts({symmetryBreaking: 'firstNodes'});
+
+  VRP.Solve(searchOpts, function (err, solution) {
+    assert.ifError(err, 'Solution can be found');
+
+    var used = solution.routes.filter(function(route) { return route.length > 0; }).length;
+
+    assert.ok(solution.routes.slice(used).every(function(route) { return route.length === 0; }), 'Empty routes come last');
+
+    for (var vehicle = 1; vehicle < used; ++vehicle)
+      assert.ok(solution.routes[vehicle - 1][0] < solution.routes[vehicle][0], 'Routes ordered by first location');
+
+    assert.end();
+  });
+});
+
+
+tap.test('Test VRP with a reusable search config', function(assert) {
+  var solverOpts = {
+    numNodes: locations.length,
+    costs: costMatrix,
+    durations: durationMatrix,
+    timeWindows: timeWindows,
+    demands: demandMatrix
+  };
+
+  var VRP = new ortools.VRP(solverOpts);
+
+  var searchOpts = makeSearchOpts({computeTimeLimit: 200});
+
+  assert.throws(function() { new ortools.VRP.SearchConfig({}); }, 'Options get validated on construction');
+  assert.throws(function() { ortools.VRP.SearchConfig({}); }, 'Options get validated without new, too');
+
+  assert.ok(ortools.VRP.SearchConfig(searchOpts) instanceof ortools.VRP.SearchConfig, 'Construction works without new');
+
+  var config = new ortools.VRP.SearchConfig(searchOpts);
+
+  var numSolves = 3;
+  var solved = 0;
+
+  for (var i = 0; i < numSolves; ++i) {
+    VRP.Solve(config, function (err, solution) {
+      assert.ifError(err, 'Solution can be found');
+      assert.equal(solution.routes.length, searchOpts.numVehicles, 'Number of routes is number of vehicles');
+
+      if (++solved === numSolves)
+        assert.end();
+    });
+  }
+});
+
+
+tap.test('Test VRP on generated instances', function(assert) {
+  var generatorOpts = {numNodes: 50, numVehicles: 5, layout: 'mixed', windowTightness: 0.5, capacityTightness: 0.8, seed: 7};
+
+  var generated = ortools.VRP.generate(generatorOpts);
+
+  assert.equal(generated.searchOptions.numVehicles, 5, 'Search options for the fleet');
+  assert.equal(generated.searchOptions.vehicleCapacities.length, 5, 'Capacities per vehicle');
+
+  assert.throws(function() { ortools.VRP.generate({numNodes: 50, numVehicles: 5, layout: 'spiral'}); }, 'Unknown layouts throw');
+
+  var searchOpts = Object.assign({computeTimeLimit: 1000}, generated.searchOptions);
+
+  generated.vrp.Solve(searchOpts, function (err, solution) {
+    assert.ifError(err, 'Solution can be found');
+    assert.equal(solution.routes.length, searchOpts.numVehicles, 'Number of routes is number of vehicles');
+    assert.end();
+  });
+});
+
+
+tap.test('Test VRP on generated instances with rising capacity tightness', function(assert) {
+  var capacityAt = function(capacityTightness) {
+    var generatorOpts = {numNodes: 51, numVehicles: 5, capacityTightness: capacityTightness, seed: 7};
+    return ortools.VRP.generate(generatorOpts).searchOptions.vehicleCapacities[0];
+  };
+
+  var tightnesses = [0, 0.1, 0.25, 0.5, 0.75, 1];
+  var capacities = tightnesses.map(capacityAt);
+
+  for (var atIdx = 1; atIdx < capacities.length; ++atIdx)
+    assert.ok(capacities[atIdx] <= capacities[atIdx - 1], 'Capacities do not grow with the tightness');
+
+  assert.ok(capacities[0] > capacities[capacities.length - 1], 'Loosest capacities exceed the tightest ones');
+  assert.ok(capacities[0] >= 5 * capacities[capacities.length - 1] - 5, 'Loosest vehicles carry all demand alone');
+
+  assert.end();
+});
+
+
+tap.test('Test VRP on seeded instances', function(assert) {
+  var generatorOpts = {numNodes: 50, numVehicles: 8, layout: 'mixed', windowTightness: 0.3, capacityTightness: 0.5, seed: 7};
+
+  var generated = ortools.VRP.generate(generatorOpts);
+  var again = ortools.VRP.generate(generatorOpts);
+
+  assert.same(again.searchOptions, generated.searchOptions, 'Same search options for the same seed');
+
+  // The construction engine is deterministic: same plans on the same costs, durations, time windows and demands
+  var searchOpts = Object.assign({computeTimeLimit: 1000, engine: 'construct'}, generated.searchOptions);
+
+  generated.vrp.Solve(searchOpts, function (err, solution) {
+    assert.ifError(err, 'Solution can be found');
+
+    again.vrp.Solve(searchOpts, function (err, solutionAgain) {
+      assert.ifError(err, 'Solution can be found');
+
+      assert.equal(solutionAgain.cost, solution.cost, 'Same cost for the same seed');
+      assert.same(solutionAgain.routes, solution.routes, 'Same routes for the same seed');
+      assert.same(solutionAgain.times, solution.times, 'Same times for the same seed');
+      assert.end();
+    });
+  });
+});